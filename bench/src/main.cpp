@@ -0,0 +1,389 @@
+#include "cppgfx/cppgfx.hpp"
+#include "cppgfx/robotofont.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The benchmarks only use the drawing state of the application, no window is opened.
+class BenchApp : public cppgfx::App {
+public:
+    void setup() override {}
+    void update() override {}
+};
+
+// Accepts all primitives and discards them, so that only the work of the drawing functions themselves is measured
+class NullRenderer : public cppgfx::Renderer {
+public:
+    void clear(const sf::Color&) override {}
+    void discard() override {}
+    void convex(const sf::Vector2f*, size_t count, const sf::Color&) override { m_stats->vertices += count; }
+    void strip(const sf::Vector2f*, size_t count, const sf::Color&) override { m_stats->vertices += count; }
+    void ring(const sf::Vector2f*, const sf::Vector2f*, size_t count, const sf::Color&) override
+    {
+        m_stats->vertices += count * 2;
+    }
+    void text(const std::string&, const sf::Vector2f&, float, const cppgfx::TextStyle&) override {}
+    void textWidths(const std::string*, size_t count, const cppgfx::TextStyle&, float* widths) override
+    {
+        std::fill(widths, widths + count, 0.f);
+    }
+    void flush() override {}
+};
+
+// A typical sketch for parameter sweeps, which draws a few hundred random shapes per frame
+class SweepApp : public cppgfx::App {
+public:
+    explicit SweepApp(uint32_t seed) : m_seed(seed) {}
+
+    void setup() override
+    {
+        size(320, 240);
+        randomSeed(m_seed);
+    }
+
+    void update() override
+    {
+        for (int i = 0; i < 200; i++) {
+            fill(randomInt(255), randomInt(255), randomInt(255));
+            circle(random(static_cast<float>(width)), random(static_cast<float>(height)), random(2, 20));
+        }
+    }
+
+private:
+    uint32_t m_seed;
+};
+
+// Run one headless sketch per thread and return the total number of frames per second
+double sweepThroughput(size_t instances, uint64_t frames)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < instances; i++) {
+        threads.emplace_back([i, frames]() {
+            SweepApp app(static_cast<uint32_t>(i));
+            app.runHeadless(frames, 1.0f / 60.0f, [](const cppgfx::SoftwareRenderer&) {});
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return static_cast<double>(instances * frames) / seconds;
+}
+
+// Stores a value where the compiler cannot see that it is never read, so that the work is not optimized away
+template<typename T>
+void keep(T value)
+{
+    static volatile T sink;
+    sink = value;
+}
+
+// =======================================
+// =====           Suite          ========
+// =======================================
+
+struct Result {
+    std::string name;
+    double nanoseconds = 0; // Median time per operation
+    double minNanoseconds = 0;
+    size_t iterations = 0;  // Iterations per sample
+    std::vector<double> samples;
+};
+
+class Suite {
+public:
+    Suite(std::string filter, std::FILE* log) : m_filter(std::move(filter)), m_log(log) {}
+
+    // Measure fn, where every call performs `operations` operations of the benchmark.
+    // The iteration count is doubled until one sample takes long enough to be measured reliably,
+    // then the median of several samples is reported.
+    template<typename Fn>
+    void run(const std::string& name, Fn&& fn, size_t operations = 1)
+    {
+        if (!m_filter.empty() && name.find(m_filter) == std::string::npos) {
+            return;
+        }
+
+        constexpr double MIN_SAMPLE_SECONDS = 0.02;
+        constexpr size_t SAMPLE_COUNT = 7;
+
+        size_t iterations = 1;
+        while (sample(iterations, fn) < MIN_SAMPLE_SECONDS && iterations < (size_t(1) << 30)) {
+            iterations *= 2;
+        }
+
+        Result result;
+        result.name = name;
+        result.iterations = iterations;
+        double count = static_cast<double>(iterations * operations);
+        for (size_t i = 0; i < SAMPLE_COUNT; i++) {
+            result.samples.push_back(sample(iterations, fn) * 1e9 / count);
+        }
+        std::vector<double> sorted = result.samples;
+        std::sort(sorted.begin(), sorted.end());
+        result.nanoseconds = sorted[sorted.size() / 2];
+        result.minNanoseconds = sorted.front();
+
+        fmt::print(m_log, "{:<32} {:>12.2f} ns {:>12.2f} ns (min)\n",
+                   name,
+                   result.nanoseconds,
+                   result.minNanoseconds);
+        m_results.push_back(std::move(result));
+    }
+
+    // Add a result that was measured by the caller
+    void add(const std::string& name, double nanoseconds)
+    {
+        if (!m_filter.empty() && name.find(m_filter) == std::string::npos) {
+            return;
+        }
+        fmt::print(m_log, "{:<32} {:>12.2f} ns\n", name, nanoseconds);
+        Result result;
+        result.name = name;
+        result.nanoseconds = nanoseconds;
+        result.minNanoseconds = nanoseconds;
+        result.iterations = 1;
+        result.samples.push_back(nanoseconds);
+        m_results.push_back(std::move(result));
+    }
+
+    bool enabled(const std::string& prefix) const
+    {
+        return m_filter.empty() || prefix.find(m_filter) != std::string::npos
+            || m_filter.find(prefix) != std::string::npos;
+    }
+
+    void writeJson(std::ostream& out) const
+    {
+#ifdef NDEBUG
+        const char* buildType = "release";
+#else
+        const char* buildType = "debug";
+#endif
+        out << "{\n";
+        out << fmt::format("  \"context\": {{ \"build\": \"{}\", \"cores\": {} }},\n",
+                           buildType,
+                           std::thread::hardware_concurrency());
+        out << "  \"benchmarks\": [";
+        for (size_t i = 0; i < m_results.size(); i++) {
+            const Result& result = m_results[i];
+            out << (i == 0 ? "\n" : ",\n");
+            out << fmt::format("    {{ \"name\": \"{}\", \"ns_per_op\": {:.3f}, \"min_ns_per_op\": {:.3f}, "
+                               "\"iterations\": {}, \"samples\": [{:.3f}] }}",
+                               result.name,
+                               result.nanoseconds,
+                               result.minNanoseconds,
+                               result.iterations,
+                               fmt::join(result.samples, ", "));
+        }
+        out << "\n  ]\n}\n";
+    }
+
+private:
+    template<typename Fn>
+    static double sample(size_t iterations, Fn& fn)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++) {
+            fn();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    std::string m_filter;
+    std::FILE* m_log;
+    std::vector<Result> m_results;
+};
+
+// =======================================
+// =====        Benchmarks        ========
+// =======================================
+
+// Shapes with a fill and an outline, the way most sketches draw them
+void shapeBenchmarks(Suite& suite, BenchApp& app, const std::string& suffix)
+{
+    app.fill(200, 100, 50);
+    app.stroke(0, 0, 0);
+    app.strokeWeight(2);
+
+    suite.run("rect" + suffix, [&]() { app.rect(10.5f, 20.25f, 120, 80); });
+    suite.run("circle" + suffix, [&]() { app.circle(160, 120, 40); });
+    suite.run("line" + suffix, [&]() { app.line(10, 10, 300, 200); });
+    suite.run("triangle" + suffix, [&]() { app.triangle(10, 10, 200, 40, 80, 220); });
+    suite.run("vector" + suffix, [&]() { app.vector(120, 80, 100, 100); });
+
+    // Drawing the same text every frame, so it is found in the text cache
+    app.fill(255, 255, 255);
+    app.strokeWeight(0);
+    suite.run("text" + suffix, [&]() { app.text("Sensor 42: 23.5 degrees", 20, 20); });
+}
+
+// Measure a typical label, one at a time and in batches
+void textWidthBenchmarks(Suite& suite, BenchApp& app, const std::string& suffix)
+{
+    constexpr size_t LABEL_COUNT = 1000;
+    std::vector<std::string> labels(LABEL_COUNT);
+    for (size_t i = 0; i < LABEL_COUNT; i++) {
+        labels[i] = "Sensor " + std::to_string(i) + ": 23.5 degrees";
+    }
+    std::vector<float> widths(LABEL_COUNT);
+
+    suite.run("textWidth" + suffix, [&]() {
+        for (size_t i = 0; i < LABEL_COUNT; i++) {
+            widths[i] = app.textWidth(labels[i]);
+        }
+    }, LABEL_COUNT);
+    suite.run("textWidths" + suffix, [&]() {
+        app.textWidths(labels.data(), labels.size(), widths.data());
+    }, LABEL_COUNT);
+}
+
+void styleBenchmarks(Suite& suite, BenchApp& app, const sf::Font& font)
+{
+    auto pushPop = [&app]() {
+        app.push();
+        app.pop();
+    };
+    suite.run("push_pop", pushPop);
+
+    app.push();
+    app.textFont(font);
+    suite.run("push_pop.custom_font", pushPop);
+    app.pop();
+}
+
+void utilityBenchmarks(Suite& suite, BenchApp& app)
+{
+    app.randomSeed(1);
+    suite.run("random", [&]() { keep(app.random(100.f)); });
+    suite.run("random_range", [&]() { keep(app.random(-50.f, 50.f)); });
+    suite.run("randomInt", [&]() { keep(app.randomInt(100)); });
+
+    float x = 0.f;
+    suite.run("dist", [&]() {
+        keep(app.dist(x, 2.f, 30.f, 40.f));
+        x += 0.5f;
+    });
+
+    // A typical small image or binary blob
+    std::vector<uint8_t> data(1024);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    std::string encoded = cppgfx::encode_base64(data);
+    suite.run("encode_base64.1k", [&]() { keep(cppgfx::encode_base64(data).size()); });
+    suite.run("decode_base64.1k", [&]() { keep(cppgfx::decode_base64(encoded).size()); });
+}
+
+// The overhead of distributing small pieces of work, and the speedup on a simulation sized loop
+void jobBenchmarks(Suite& suite, BenchApp& app)
+{
+    suite.run("submit_wait", [&]() { app.submit([]() { return 1; }).get(); });
+
+    constexpr size_t PARTICLE_COUNT = 100000;
+    std::vector<sf::Vector2f> positions(PARTICLE_COUNT);
+    std::vector<sf::Vector2f> velocities(PARTICLE_COUNT, sf::Vector2f(1.f, 2.f));
+    auto step = [&](size_t i) {
+        velocities[i].y += 9.81f / 60.f;
+        positions[i] += velocities[i] / 60.f;
+    };
+    suite.run("particles.serial", [&]() {
+        for (size_t i = 0; i < PARTICLE_COUNT; i++) {
+            step(i);
+        }
+    }, PARTICLE_COUNT);
+    suite.run("particles.parallelFor", [&]() { app.parallelFor(0, PARTICLE_COUNT, 0, step); }, PARTICLE_COUNT);
+    keep(positions[0].y);
+}
+
+// Independent headless instances should scale almost linearly with the number of cores
+void scalingBenchmarks(Suite& suite)
+{
+    if (!suite.enabled("headless_instances")) {
+        return;
+    }
+    constexpr uint64_t SWEEP_FRAMES = 200;
+    size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    for (size_t instances = 1; instances <= cores; instances *= 2) {
+        double throughput = sweepThroughput(instances, SWEEP_FRAMES);
+        suite.add(fmt::format("headless_instances.{}", instances), 1e9 / throughput);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string jsonPath;
+    std::string filter;
+    bool sfml = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        }
+        else if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        }
+        else if (arg == "--sfml") {
+            sfml = true;
+        }
+        else {
+            fmt::print("Usage: cppgfx_bench [--json <file>] [--filter <text>] [--sfml]\n"
+                       "  --json    Write the results as JSON, use - for stdout\n"
+                       "  --filter  Only run benchmarks whose name contains the text\n"
+                       "  --sfml    Also run benchmarks of the SFML renderer, which need an OpenGL context\n");
+            return 1;
+        }
+    }
+
+    sf::Font font;
+    if (!font.loadFromMemory(cppgfx::ROBOTO_MEDIUM_DATA, cppgfx::ROBOTO_MEDIUM_SIZE)) {
+        fmt::print("Failed to load the benchmark font\n");
+        return 1;
+    }
+
+    // The results are printed to stderr when the JSON goes to stdout
+    Suite suite(filter, (jsonPath == "-") ? stderr : stdout);
+
+    // The cost of the drawing functions alone
+    BenchApp app;
+    app.setRenderer(std::make_unique<NullRenderer>());
+    shapeBenchmarks(suite, app, "");
+    styleBenchmarks(suite, app, font);
+    utilityBenchmarks(suite, app);
+    jobBenchmarks(suite, app);
+
+    // Everything up to the pixels, without a GPU
+    BenchApp softwareApp;
+    softwareApp.setRenderer(std::make_unique<cppgfx::SoftwareRenderer>(640, 480));
+    shapeBenchmarks(suite, softwareApp, ".software");
+    textWidthBenchmarks(suite, softwareApp, ".software");
+
+    // Glyphs of the SFML renderer are uploaded into font textures, which needs an OpenGL context
+    if (sfml) {
+        BenchApp sfmlApp;
+        textWidthBenchmarks(suite, sfmlApp, ".sfml");
+    }
+
+    scalingBenchmarks(suite);
+
+    if (jsonPath == "-") {
+        suite.writeJson(std::cout);
+    }
+    else if (!jsonPath.empty()) {
+        std::ofstream file(jsonPath);
+        suite.writeJson(file);
+        if (!file) {
+            fmt::print("Failed to write {}\n", jsonPath);
+            return 1;
+        }
+    }
+}
@@ -36,6 +36,11 @@ FetchContent_Declare(imgui-sfml
 set(IMGUI_SFML_FIND_SFML OFF CACHE BOOL "" FORCE)
 set(IMGUI_SFML_IMGUI_DEMO ON CACHE BOOL "" FORCE)
 set(IMGUI_DIR ${imgui_SOURCE_DIR} CACHE PATH "" FORCE)
+# ImGui-SFML defines IMGUI_USER_CONFIG for itself, ImGui and everything that links it, so the config is set here
+# once. cppgfx/imconfig.hpp includes the default imconfig-SFML.h, which keeps the SFML conversions.
+set(IMGUI_SFML_USE_DEFAULT_CONFIG OFF CACHE BOOL "" FORCE)
+set(IMGUI_SFML_CONFIG_DIR ${PROJECT_SOURCE_DIR}/include CACHE PATH "" FORCE)
+set(IMGUI_SFML_CONFIG_NAME "cppgfx/imconfig.hpp" CACHE STRING "" FORCE)
 FetchContent_MakeAvailable(imgui-sfml)
 
 message(STATUS "Fetching glm")
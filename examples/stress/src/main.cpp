@@ -0,0 +1,370 @@
+#include "cppgfx/cppgfx.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// Scripted scenes that stress one part of cppgfx each. Every scene runs for a fixed number of frames and reports
+// the mean framerate, the median and 99th percentile frame time and the peak memory of the process.
+//
+// Usage: stress <scene|all> [--frames <count>] [--headless]
+//
+// With --headless, the scenes are drawn with the software renderer instead of a window.
+
+// The largest amount of physical memory the process has used so far
+size_t peakMemoryBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters {};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+struct Report {
+    double meanFps = 0;
+    double p50 = 0; // Frame times in milliseconds
+    double p99 = 0;
+    size_t peakMemory = 0;
+};
+
+// Takes care of timing, the scenes only draw
+class StressScene : public cppgfx::App {
+public:
+    // The first frames are not measured, while caches and buffers warm up
+    static constexpr uint64_t WARMUP_FRAMES = 10;
+
+    StressScene(std::string name, uint64_t frames) : m_name(std::move(name)), m_frames(frames) {}
+
+    void setup() override
+    {
+        size(1280, 720);
+        setTitle("cppgfx stress test: " + m_name);
+        setFrameRate(0);
+        backgroundMode = BackgroundMode::Continue;
+        randomSeed(1);
+        prepare();
+    }
+
+    void update() override
+    {
+        // The time between two calls of update() is the complete frame, including event handling and display
+        auto now = std::chrono::steady_clock::now();
+        if (frameCount > WARMUP_FRAMES) {
+            m_frameTimes.push_back(std::chrono::duration<double, std::milli>(now - m_lastUpdate).count());
+        }
+        m_lastUpdate = now;
+
+        if (frameCount >= WARMUP_FRAMES + m_frames) {
+            close();
+            return;
+        }
+
+        background(25);
+        draw();
+    }
+
+    Report report() const
+    {
+        Report report;
+        report.peakMemory = peakMemoryBytes();
+        if (m_frameTimes.empty()) {
+            return report;
+        }
+
+        std::vector<double> sorted = m_frameTimes;
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&sorted](double p) {
+            size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+            return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+        };
+
+        double total = 0;
+        for (double time : sorted) {
+            total += time;
+        }
+        report.meanFps = 1000.0 * static_cast<double>(sorted.size()) / total;
+        report.p50 = percentile(0.50);
+        report.p99 = percentile(0.99);
+        return report;
+    }
+
+    const std::string& name() const { return m_name; }
+
+protected:
+    virtual void prepare() {}
+    virtual void draw() = 0;
+
+private:
+    std::string m_name;
+    uint64_t m_frames;
+    std::vector<double> m_frameTimes;
+    std::chrono::steady_clock::time_point m_lastUpdate;
+};
+
+// =======================================
+// =====          Scenes          ========
+// =======================================
+
+// Many small particles with an outline, slowly drifting
+class CirclesScene : public StressScene {
+public:
+    using StressScene::StressScene;
+
+    static constexpr size_t COUNT = 100'000;
+
+    void prepare() override
+    {
+        for (size_t i = 0; i < COUNT; i++) {
+            m_particles.push_back({ random(1280.f), random(720.f), random(2, 6), random(-1, 1), random(-1, 1) });
+        }
+    }
+
+    void draw() override
+    {
+        stroke(0, 0, 0);
+        strokeWeight(1);
+        fill(80, 160, 230);
+        float t = static_cast<float>(frameCount);
+        for (const auto& p : m_particles) {
+            circle(p.x + p.dx * t, p.y + p.dy * t, p.radius);
+        }
+    }
+
+private:
+    struct Particle {
+        float x, y, radius, dx, dy;
+    };
+    std::vector<Particle> m_particles;
+};
+
+// Line charts, like many sensor traces on a dashboard
+class LinesScene : public StressScene {
+public:
+    using StressScene::StressScene;
+
+    static constexpr size_t TRACES = 100;
+    static constexpr size_t SEGMENTS = 500;
+
+    void draw() override
+    {
+        strokeWeight(1.5f);
+        float t = static_cast<float>(frameCount) * 0.05f;
+        float step = 1280.f / static_cast<float>(SEGMENTS);
+        for (size_t trace = 0; trace < TRACES; trace++) {
+            stroke(static_cast<uint8_t>(trace * 37 % 255), 200, static_cast<uint8_t>(255 - trace * 2));
+            float base = 7.2f * static_cast<float>(trace);
+            float phase = static_cast<float>(trace) * 0.3f + t;
+            for (size_t i = 0; i < SEGMENTS; i++) {
+                float x = static_cast<float>(i) * step;
+                float y1 = base + 5.f * sinf(x * 0.05f + phase);
+                float y2 = base + 5.f * sinf((x + step) * 0.05f + phase);
+                line(x, y1, x + step, y2);
+            }
+        }
+    }
+};
+
+// A grid of labels, where a tenth of the values change every frame
+class LabelsScene : public StressScene {
+public:
+    using StressScene::StressScene;
+
+    static constexpr size_t COUNT = 10'000;
+
+    void prepare() override
+    {
+        for (size_t i = 0; i < COUNT; i++) {
+            m_values.push_back(random(0, 100));
+        }
+    }
+
+    void draw() override
+    {
+        fill(230, 230, 230);
+        textSize(10);
+        for (size_t i = frameCount % 10; i < COUNT; i += 10) {
+            m_values[i] = random(0, 100);
+        }
+        for (size_t i = 0; i < COUNT; i++) {
+            float x = static_cast<float>(i % 100) * 12.8f;
+            float y = static_cast<float>(i / 100) * 7.2f;
+            text(fmt::format("{}: {:.1f}", i, m_values[i]), x, y);
+        }
+    }
+
+private:
+    std::vector<float> m_values;
+};
+
+// Nested groups that each change the style, like a widget tree
+class NestingScene : public StressScene {
+public:
+    using StressScene::StressScene;
+
+    static constexpr size_t GROUPS = 2000;
+    static constexpr size_t DEPTH = 32;
+
+    void draw() override
+    {
+        for (size_t group = 0; group < GROUPS; group++) {
+            float x = static_cast<float>(group % 50) * 25.6f;
+            float y = static_cast<float>(group / 50) * 18.f;
+            for (size_t level = 0; level < DEPTH; level++) {
+                push();
+                fill(static_cast<uint8_t>(level * 8), static_cast<uint8_t>(group % 255), 128);
+                strokeWeight(static_cast<float>(level % 3));
+                if (level % 8 == 7) {
+                    rect(x + static_cast<float>(level) * 0.5f, y, 4, 4);
+                }
+            }
+            for (size_t level = 0; level < DEPTH; level++) {
+                pop();
+            }
+        }
+    }
+};
+
+// A control panel with several ImGui windows on top of a drawing
+class MixedScene : public StressScene {
+public:
+    using StressScene::StressScene;
+
+    static constexpr size_t SHAPES = 10'000;
+    static constexpr size_t WINDOWS = 8;
+
+    void draw() override
+    {
+        strokeWeight(1);
+        stroke(0, 0, 0);
+        for (size_t i = 0; i < SHAPES; i++) {
+            float x = static_cast<float>(i % 125) * 10.24f;
+            float y = static_cast<float>(i / 125) * 9.f;
+            fill(static_cast<uint8_t>(i % 255), 120, 200);
+            if (i % 2 == 0) {
+                rect(x, y, 8, 7);
+            }
+            else {
+                circle(x + 4, y + 4, 4);
+            }
+        }
+
+        for (size_t window = 0; window < WINDOWS; window++) {
+            ImVec2 position(static_cast<float>(window % 4) * 320.f, static_cast<float>(window / 4) * 360.f);
+            ImGui::SetNextWindowPos(position, ImGuiCond_Always);
+            ImGui::SetNextWindowSize(ImVec2(310, 350), ImGuiCond_Always);
+            ImGui::Begin(fmt::format("Panel {}", window).c_str());
+            for (size_t i = 0; i < 8; i++) {
+                ImGui::SliderFloat(fmt::format("Gain {}", i).c_str(), &m_gains[window][i], 0.f, 1.f);
+            }
+            float samples[64];
+            for (size_t i = 0; i < 64; i++) {
+                samples[i] = sinf(static_cast<float>(i + frameCount + window * 10) * 0.2f);
+            }
+            ImGui::PlotLines("Signal", samples, 64, 0, nullptr, -1.f, 1.f, ImVec2(0, 80));
+            for (size_t i = 0; i < 10; i++) {
+                ImGui::Text("Channel %zu: %.3f", i, samples[i]);
+            }
+            ImGui::End();
+        }
+    }
+
+private:
+    float m_gains[WINDOWS][8] {};
+};
+
+// =======================================
+// =====           Main           ========
+// =======================================
+
+using SceneFactory = std::function<std::unique_ptr<StressScene>(uint64_t frames)>;
+
+template<typename Scene>
+std::pair<std::string, SceneFactory> scene(const std::string& name)
+{
+    return { name, [name](uint64_t frames) { return std::make_unique<Scene>(name, frames); } };
+}
+
+int main(int argc, char** argv)
+{
+    const std::vector<std::pair<std::string, SceneFactory>> scenes = {
+        scene<CirclesScene>("circles"), scene<LinesScene>("lines"),   scene<LabelsScene>("labels"),
+        scene<NestingScene>("nesting"), scene<MixedScene>("mixed"),
+    };
+
+    std::string selected;
+    uint64_t frames = 600;
+    bool headless = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = std::stoull(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        }
+        else {
+            selected = argv[i];
+        }
+    }
+
+    bool found = (selected == "all");
+    for (const auto& [name, factory] : scenes) {
+        found = found || (name == selected);
+    }
+    if (!found) {
+        fmt::print("Usage: stress <scene|all> [--frames <count>] [--headless]\nScenes:");
+        for (const auto& [name, factory] : scenes) {
+            fmt::print(" {}", name);
+        }
+        fmt::print("\n");
+        return 1;
+    }
+
+    fmt::print("{:<10} {:>10} {:>10} {:>10} {:>12}\n", "scene", "mean fps", "p50 ms", "p99 ms", "peak MiB");
+    for (const auto& [name, factory] : scenes) {
+        if (selected != "all" && selected != name) {
+            continue;
+        }
+        auto app = factory(frames);
+        if (headless) {
+            uint64_t total = StressScene::WARMUP_FRAMES + frames + 1;
+            app->runHeadless(total, 1.0f / 60.0f, [](const cppgfx::SoftwareRenderer&) {});
+        }
+        else {
+            app->run();
+        }
+        Report report = app->report();
+        fmt::print("{:<10} {:>10.1f} {:>10.2f} {:>10.2f} {:>12.1f}\n",
+                   name,
+                   report.meanFps,
+                   report.p50,
+                   report.p99,
+                   static_cast<double>(report.peakMemory) / (1024.0 * 1024.0));
+    }
+
+    // The memory peak belongs to the whole process, so it only isolates a scene when it runs alone
+    if (selected == "all") {
+        fmt::print("Peak memory is cumulative, run a single scene to measure its memory alone\n");
+    }
+}
@@ -10,14 +10,33 @@
 #include "spdlog/fmt/fmt.h"
 #include "spdlog/fmt/std.h"
 #include "spdlog/fmt/ranges.h"
+#include <array>
+#include <bitset>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <random>
 
 #include "glm/glm.hpp"
 
 #include "imgui.h"
 
+#ifndef CPPGFX_STYLE_STACK_DEPTH
+#define CPPGFX_STYLE_STACK_DEPTH 64
+#endif
+
 #include "cppgfx/base64.hpp"
+#include "cppgfx/fixedstack.hpp"
+#include "cppgfx/framepacer.hpp"
+#include "cppgfx/frameprofiler.hpp"
+#include "cppgfx/lazywindow.hpp"
+#include "cppgfx/framestats.hpp"
+#include "cppgfx/inputevent.hpp"
+#include "cppgfx/jobsystem.hpp"
+#include "cppgfx/profiler.hpp"
+#include "cppgfx/renderer.hpp"
+#include "cppgfx/sfmlrenderer.hpp"
+#include "cppgfx/softwarerenderer.hpp"
 
 ///
 /// @defgroup Window
@@ -54,6 +73,11 @@
 /// @brief All cppgfx functions you can override, including Events.
 ///
 
+///
+/// @defgroup Threading
+/// @brief Running work in parallel on all CPU cores
+///
+
 enum class TextAlign {
     Left,
     Center,
@@ -71,15 +95,45 @@ enum class RectMode {
     Corners // Origin is at top left corner and x y is bottom right corner
 };
 
+enum class BackgroundMode {
+    Continue,         // Keep running at the normal framerate
+    ReducedFrameRate, // Keep running at the background framerate
+    PauseRendering,   // Keep calling update() at the background framerate, but do not draw anything
+    Suspend           // Do nothing until the window is in the foreground again
+};
+
 namespace cppgfx {
 
+    /// @brief A lightweight handle to a font that is owned by the application
+    /// @details Handles are returned by App::openFont() and can be copied freely, the font itself is loaded only once
+    ///          and lives as long as the application. A default constructed handle refers to the default font.
+    ///          The handle converts to an sf::Font, in case you need it for the SFML API directly.
+    class Font {
+    public:
+        Font() = default;
+
+        /// @brief Access the SFML font this handle refers to
+        operator const sf::Font&() const;
+
+    private:
+        friend class App;
+        explicit Font(uint32_t id) : m_id(id) {}
+
+        uint32_t m_id = 0;
+    };
+
     /// @brief The main application class
-    /// @details This class is supposed to be inherited by the user.
+    /// @details This class is supposed to be inherited by the user. Every instance is independent, so several
+    ///          applications can run on separate threads at the same time, for example with runHeadless().
     class App {
+        // Declared first, so that it is destroyed after everything that refers to the window
+        LazyWindow m_window;
+
     public:
         App();
         ~App();
 
+        /// @brief Get the application that was created or is running on the current thread
         static App& Get() {
             if (m_instance == nullptr) {
                 throw std::logic_error("cppgfx::App::Get(): No instance of cppgfx::App exists. "
@@ -93,7 +147,12 @@ namespace cppgfx {
         /// @ingroup Window
         /// @details This is the SFML RenderWindow which is used to draw everything. If you have the knowledge,
         ///          you can use this variable to access the SFML API directly in order to draw more complex things.
-        sf::RenderWindow window;
+        ///          cppgfx primitives are batched, so call flush() before drawing to the window directly
+        ///          if the order matters.
+        /// @note The window object is only constructed when it is first needed, because SFML needs a display
+        ///       for it even before it is opened. run() constructs it before setup() is called, runHeadless()
+        ///       never does. Outside of run(), call getWindow() before using this variable.
+        sf::RenderWindow& window;
 
         /// @brief If the dark title bar should be used
         /// @ingroup Window
@@ -129,12 +188,37 @@ namespace cppgfx {
         ///          Use the setTitle() function to change the title of the window.
         std::string title = "My cppgfx application";
 
+        /// @brief What the application does while the window is unfocused or minimized
+        /// @ingroup Window
+        /// @details By default, the application keeps running at its normal framerate. Set this to
+        ///          BackgroundMode::ReducedFrameRate or one of the other modes, so that an application in the
+        ///          background does not waste CPU and GPU time. Minimized windows are only detected on Windows,
+        ///          on other platforms minimized windows are usually unfocused as well.
+        BackgroundMode backgroundMode = BackgroundMode::Continue;
+
+        /// @brief The framerate limit while the window is in the background, see backgroundMode
+        /// @ingroup Window
+        float backgroundFrameRate = 10;
+
         /// @brief If the window is currently focused or not [read only]
         /// @ingroup Window
         /// @details This variable is automatically updated and will not affect anything if you change it.
         ///          Use focus() to request window to be focused.
         bool focused = true;
 
+        /// @brief If input events render a new frame, while the application is stopped using noLoop()
+        /// @ingroup Window
+        /// @details When this is enabled, keyboard and mouse events automatically render a frame, so that user
+        ///          interfaces stay responsive without calling redraw() manually.
+        bool redrawOnInput = true;
+
+        /// @brief If mouse moves are combined into one onMouseMoved() call per frame
+        /// @ingroup Input
+        /// @details High rate mice can deliver hundreds of moves per frame. When this is enabled, onMouseMoved() is
+        ///          only called once per frame with the last position, right before update(). Every single move is
+        ///          still available in inputEvents(), e.g. for drawing applications that need all samples.
+        bool coalesceMouseMoves = false;
+
         /// @brief The frame count since the program started [read only]
         /// @ingroup Window
         /// @details This variable starts at 0 and is incremented for every frame. Keep in mind that using the framecount
@@ -157,6 +241,48 @@ namespace cppgfx {
         ///          This variable is automatically updated and will not affect anything if you change it.
         float frameRate = 0;
 
+        /// @brief How often per second simulate() is called, or 0 to never call it
+        /// @ingroup Window
+        /// @details When this is set, simulate() is called with a fixed time step of 1 / simulationRate seconds,
+        ///          as many times as needed to keep up with the real time. Depending on the framerate, this can be
+        ///          zero, one or several times per frame, always right before update().
+        float simulationRate = 0;
+
+        /// @brief The maximum number of simulate() calls per frame
+        /// @ingroup Window
+        /// @details If the simulation cannot keep up, e.g. because one step takes longer than its time step, the
+        ///          remaining time is dropped after this many steps. The simulation then runs slower than the real
+        ///          time, instead of taking longer and longer every frame.
+        uint32_t maxSimulationSteps = 8;
+
+        /// @brief How far the real time is between the last and the next simulation step [read only]
+        /// @ingroup Window
+        /// @details This is a value from 0 to 1, which can be used in update() to interpolate between the previous
+        ///          and the current simulation state, so that motion is smooth even when the simulation runs at a
+        ///          lower rate than the framerate. If simulationRate is 0, it is always 1.
+        ///          This variable is automatically updated and will not affect anything if you change it.
+        float interpolationAlpha = 1;
+
+        /// @brief The number of simulate() calls in the current frame [read only]
+        /// @ingroup Window
+        /// @details This variable is automatically updated and will not affect anything if you change it.
+        uint32_t simulationSteps = 0;
+
+        /// @brief Rendering statistics of the last frame [read only]
+        /// @ingroup Window
+        /// @details This contains counters like the number of draw calls and vertices of the last completed frame.
+        ///          It is intended for debugging purposes and diagnostics.
+        ///          This variable is automatically updated and will not affect anything if you change it.
+        FrameStats frameStats;
+
+        /// @brief If the frame profiler overlay is shown
+        /// @ingroup Window
+        /// @details The overlay is an ImGui window with a stacked graph of how long the phases of the last frames
+        ///          took (event polling, update(), batch flush, ImGui and display), together with the min, average,
+        ///          p95, p99 and max frame time and the frameStats of the last frame. The phases are always
+        ///          measured, this only controls the overlay.
+        bool showProfiler = false;
+
         /// @brief The mathematical constant PI
         /// @ingroup Math
         constexpr static float PI = 3.14159265358979323846f;
@@ -222,6 +348,14 @@ namespace cppgfx {
         /// @details It must be overridden in your class which inherits from cppgfx::App.
         virtual void update() = 0;
 
+        /// @brief This function is called at a fixed rate to advance a simulation, see simulationRate
+        /// @ingroup Events
+        /// @details Since the time step is always the same, a simulation behaves exactly the same on every machine
+        ///          and at every framerate. Do not draw here, drawing belongs into update().
+        ///          It can optionally be overridden in your class which inherits from cppgfx::App.
+        /// @param dt The time step in seconds, which is 1 / simulationRate
+        virtual void simulate(float dt) {}
+
         /// @brief This function is called once at the end of the program.
         /// @ingroup Events
         /// @details It can be overridden in your class which inherits from cppgfx::App.
@@ -377,6 +511,8 @@ namespace cppgfx {
         /// @details This function will push the current draw style onto the stack, so that it can be restored later.
         ///          This mechanism is very useful when you want to temporarily change the draw style, and later
         ///          change it back to what it was.
+        ///          The stack has a fixed depth (CPPGFX_STYLE_STACK_DEPTH, 64 by default) and never allocates.
+        ///          Pushing onto a full stack throws an exception, which usually means that a pop() is missing.
         void push();
 
         /// @brief Pop the current draw style from the stack
@@ -394,6 +530,50 @@ namespace cppgfx {
         /// @param y2 The y coordinate of the second point in pixels, relative to the top left corner of the window
         void line(float x1, float y1, float x2, float y2);
 
+        /// @brief Draw many lines at once
+        /// @ingroup Graphics
+        /// @details This is equivalent to calling line() for every element, but much faster, because the current
+        ///          style is only looked up once. All arrays must contain at least count elements.
+        /// @param x1 The x coordinates of the first points
+        /// @param y1 The y coordinates of the first points
+        /// @param x2 The x coordinates of the second points
+        /// @param y2 The y coordinates of the second points
+        /// @param count The number of lines to draw
+        void lines(const float* x1, const float* y1, const float* x2, const float* y2, size_t count);
+
+        /// @brief Draw many lines at once
+        /// @ingroup Graphics
+        /// @details This is equivalent to calling line() for every element, but much faster, because the current
+        ///          style is only looked up once. All arrays must contain at least count elements.
+        /// @param start The first points of the lines
+        /// @param end The second points of the lines
+        /// @param count The number of lines to draw
+        void lines(const glm::vec2* start, const glm::vec2* end, size_t count);
+
+        /// @brief Draw a point at (x, y)
+        /// @ingroup Graphics
+        /// @details A point is a dot in the stroke color, the stroke weight is its diameter.
+        /// @param x The x coordinate of the point in pixels, relative to the top left corner of the window
+        /// @param y The y coordinate of the point in pixels, relative to the top left corner of the window
+        void point(float x, float y);
+
+        /// @brief Draw many points at once
+        /// @ingroup Graphics
+        /// @details This is equivalent to calling point() for every element, but much faster, because the current
+        ///          style is only looked up once. All arrays must contain at least count elements.
+        /// @param x The x coordinates of the points
+        /// @param y The y coordinates of the points
+        /// @param count The number of points to draw
+        void points(const float* x, const float* y, size_t count);
+
+        /// @brief Draw many points at once
+        /// @ingroup Graphics
+        /// @details This is equivalent to calling point() for every element, but much faster, because the current
+        ///          style is only looked up once. The array must contain at least count elements.
+        /// @param positions The positions of the points
+        /// @param count The number of points to draw
+        void points(const glm::vec2* positions, size_t count);
+
         /// @brief Set the line cap style
         /// @ingroup Graphics
         /// @param cap The line cap style
@@ -408,6 +588,26 @@ namespace cppgfx {
         /// @param h The second y coordinate in pixels, relative to the top left corner of the window
         void rect(float x, float y, float w, float h);
 
+        /// @brief Draw many rectangles at once
+        /// @ingroup Graphics
+        /// @details This is equivalent to calling rect() for every element, but much faster, because the current
+        ///          style is only looked up once. All arrays must contain at least count elements.
+        /// @param x The first x coordinates, see rect()
+        /// @param y The first y coordinates, see rect()
+        /// @param w The second x coordinates, see rect()
+        /// @param h The second y coordinates, see rect()
+        /// @param count The number of rectangles to draw
+        void rects(const float* x, const float* y, const float* w, const float* h, size_t count);
+
+        /// @brief Draw many rectangles at once
+        /// @ingroup Graphics
+        /// @details This is equivalent to calling rect() for every element, but much faster, because the current
+        ///          style is only looked up once. All arrays must contain at least count elements.
+        /// @param positions The first coordinates, see rect()
+        /// @param sizes The second coordinates, see rect()
+        /// @param count The number of rectangles to draw
+        void rects(const glm::vec2* positions, const glm::vec2* sizes, size_t count);
+
         /// @brief Where the origin of the rectangle is
         /// @ingroup Graphics
         /// @details This function will change the meaning of the x, y, w and h parameters of the rect() function.
@@ -426,6 +626,25 @@ namespace cppgfx {
         /// @param radius The radius of the circle in pixels
         void circle(float x, float y, float radius);
 
+        /// @brief Draw many circles at once
+        /// @ingroup Graphics
+        /// @details This is equivalent to calling circle() for every element, but much faster, because the current
+        ///          style is only looked up once. All arrays must contain at least count elements.
+        /// @param x The x coordinates of the centers of the circles
+        /// @param y The y coordinates of the centers of the circles
+        /// @param radius The radii of the circles
+        /// @param count The number of circles to draw
+        void circles(const float* x, const float* y, const float* radius, size_t count);
+
+        /// @brief Draw many circles at once
+        /// @ingroup Graphics
+        /// @details This is equivalent to calling circle() for every element, but much faster, because the current
+        ///          style is only looked up once. All arrays must contain at least count elements.
+        /// @param centers The centers of the circles
+        /// @param radius The radii of the circles
+        /// @param count The number of circles to draw
+        void circles(const glm::vec2* centers, const float* radius, size_t count);
+
         /// @brief Draw an ellipse at (x, y) with the given width and height
         /// @ingroup Graphics
         /// @param x The x coordinate of the center of the ellipse in pixels, relative to the top left corner of the window
@@ -456,15 +675,36 @@ namespace cppgfx {
 
         /// @brief Set the current font to be used for rendering from now on
         /// @ingroup Graphics
+        /// @param font The font to use, as returned by openFont()
+        void textFont(Font font);
+
+        /// @brief Set the current font to be used for rendering from now on
+        /// @ingroup Graphics
+        /// @details The application keeps a copy of the font, so the font may be destroyed afterwards, it can
+        ///          also be a temporary. Passing the same object again reuses its copy. When another font is
+        ///          passed from an address that was seen before, it replaces the copy of the old font.
+        ///          The copy shares the font data with the original: A font loaded with loadFromMemory() still
+        ///          needs its memory to stay alive. Prefer the overload taking a Font handle from openFont():
+        ///          SFML does not give access to the file of an sf::Font, so the SoftwareRenderer draws text of
+        ///          these fonts with the default font.
         /// @param font The SFML font to use
         void textFont(const sf::Font& font);
 
-        /// @brief Load a font from a file with a specific size
+        /// @brief Load a font from a file
         /// @ingroup Graphics
         /// @param filename The filename of the font to load
         /// @return The loaded font
         sf::Font loadFont(const std::string& filename);
 
+        /// @brief Load a font from a file and keep it in the application
+        /// @ingroup Graphics
+        /// @details The font is owned by the application and lives as long as it does. Call this once, e.g. in
+        ///          setup(), and keep the handle: Every call loads the file again. Unlike fonts passed to
+        ///          textFont() as an sf::Font, these fonts are also used by the SoftwareRenderer.
+        /// @param filename The filename of the font to load
+        /// @return A handle to the loaded font
+        Font openFont(const std::string& filename);
+
         /// @brief Set the current alignment for drawing text
         /// @ingroup Graphics
         /// @param alignment The alignment
@@ -476,6 +716,16 @@ namespace cppgfx {
         /// @return The width of the text in pixels
         float textWidth(const std::string& text);
 
+        /// @brief Calculate the widths of many text strings at once
+        /// @ingroup Graphics
+        /// @details This gives the same results as calling textWidth() for every string, but the current font
+        ///          and size are only looked up once, which makes it suited for wrapping and aligning large
+        ///          amounts of text.
+        /// @param texts The texts to measure
+        /// @param count The number of texts
+        /// @param widths Receives the width of every text in pixels, must have room for count elements
+        void textWidths(const std::string* texts, size_t count, float* widths);
+
         /// @brief Set the font size of the currently active font
         /// @ingroup Graphics
         /// @param size The font size in pixels
@@ -488,6 +738,86 @@ namespace cppgfx {
         /// @param y The y coordinate of the text in pixels, relative to the top left corner of the window
         void text(const std::string& text, float x, float y);
 
+        /// @brief Submit all pending primitives to the window
+        /// @ingroup Graphics
+        /// @details Primitives are not drawn immediately, but collected and drawn together in as few draw calls
+        ///          as possible. This happens automatically at the end of every frame. You only need to call this
+        ///          function if you draw to the window directly using the SFML API and want your drawing to
+        ///          appear on top of the primitives drawn so far.
+        void flush();
+
+        /// @brief Replace the renderer that all drawing functions go to
+        /// @ingroup Graphics
+        /// @details By default, everything is drawn to the window. A SoftwareRenderer draws into an image in
+        ///          memory instead, on the CPU and without OpenGL, so that images can be rendered on machines
+        ///          without a graphics card. The renderer can be replaced at any time, pending primitives of
+        ///          the previous renderer are drawn first.
+        /// @param renderer The new renderer, or nullptr to draw to the window again, which creates the window
+        void setRenderer(std::unique_ptr<Renderer> renderer);
+
+        /// @brief Get the renderer that all drawing functions go to
+        /// @ingroup Graphics
+        /// @details Until run() or runHeadless() chose one, this is the renderer that draws to the window.
+        /// @return The current renderer
+        Renderer& getRenderer();
+
+        /// @brief Get the main window of your application
+        /// @ingroup Window
+        /// @details This is the SFML RenderWindow which is used to draw everything. If you have the knowledge,
+        ///          you can use it to access the SFML API directly in order to draw more complex things.
+        ///          cppgfx primitives are batched, so call flush() before drawing to the window directly
+        ///          if the order matters. This is the same object as the window variable, but the window is
+        ///          constructed first if it does not exist yet, so it can be used outside of run() as well.
+        /// @return The window, which is only open while run() is running
+        sf::RenderWindow& getWindow();
+
+        /// @brief Get the frame profiler, which measures the phases of the last frames
+        /// @ingroup Window
+        /// @return The frame profiler
+        const FrameProfiler& getProfiler() const;
+
+        /// @brief Save all recorded profiler zones to a trace file
+        /// @ingroup Window
+        /// @details The trace contains the phases of every frame and all zones that were measured with
+        ///          CPPGFX_PROFILE_SCOPE("name"), on all threads. It is written in the Chrome trace event format,
+        ///          which can be opened in chrome://tracing or https://ui.perfetto.dev. Every thread keeps only
+        ///          its most recent zones, so save the trace shortly after the frames of interest.
+        ///          This throws if cppgfx was built without USE_PROFILER, which is off by default.
+        /// @param path The path of the JSON file to write
+        void saveTrace(const std::string& path);
+
+
+
+        // =======================================
+        // =====         Input API        ========
+        // =======================================
+
+        /// @brief Check if a key is currently held down
+        /// @ingroup Input
+        /// @details The state is taken from the keyboard events that were received up to the current frame, so
+        ///          it is consistent with the events and with mouseX/mouseY, and asking for it is free. When the
+        ///          window loses the focus, all keys are considered released.
+        /// @param key The key to check
+        /// @return True if the key is down
+        bool isKeyDown(sf::Keyboard::Key key) const;
+
+        /// @brief Check if a mouse button is currently held down
+        /// @ingroup Input
+        /// @details The state is taken from the mouse events that were received up to the current frame, like
+        ///          isKeyDown().
+        /// @param button The mouse button to check
+        /// @return True if the button is down
+        bool isMouseButtonDown(sf::Mouse::Button button) const;
+
+        /// @brief Get all keyboard and mouse events that were received for the current frame
+        /// @ingroup Input
+        /// @details The events are in the order they were received, each with a timestamp from the same clock as
+        ///          micros(). This includes the events received while the application was waiting for a redraw,
+        ///          and every mouse move, also when coalesceMouseMoves is enabled. In an event callback like
+        ///          onKeyPressed(), the event being handled is the last one. The list is cleared after update().
+        /// @return The events of the current frame
+        const std::vector<InputEvent>& inputEvents() const;
+
 
 
         // =======================================
@@ -509,10 +839,49 @@ namespace cppgfx {
 
         /// @brief Set the maximum framerate limit in frames per second
         /// @ingroup Window
-        /// @details This function will limit the framerate to the given value.
+        /// @details This function will limit the framerate to the given value. Fractional framerates like 59.94
+        ///          are met on average, and the frames are paced with sub-millisecond precision.
+        ///          Use 0 to render as fast as possible.
         /// @param framerate The new framerate limit
         void setFrameRate(float framerate);
 
+        /// @brief Enable or disable vertical sync
+        /// @ingroup Window
+        /// @details With vertical sync, presenting a frame waits for the next refresh of the display, which
+        ///          prevents tearing. The framerate limit still applies: Use setFrameRate(0) to let the display
+        ///          alone determine the framerate, or a lower framerate than the refresh rate to save power.
+        /// @param enabled True to enable vertical sync
+        void setVerticalSync(bool enabled);
+
+        /// @brief Get how precisely the last frames met the framerate limit
+        /// @ingroup Window
+        /// @return The lateness of the last frames compared to their deadlines
+        PacingStats getPacingStats() const;
+
+        /// @brief Stop calling update() continuously
+        /// @ingroup Window
+        /// @details After calling this function, the application no longer renders frames at the framerate limit,
+        ///          but sleeps until something needs to be drawn. A new frame is rendered when redraw() is called,
+        ///          when the window is resized or focused, and on input events if redrawOnInput is enabled. This
+        ///          uses almost no CPU while nothing changes, which is ideal for static displays. If it is called
+        ///          in setup(), update() still runs once to draw the first frame.
+        void noLoop();
+
+        /// @brief Continuously call update() again, after noLoop() was called
+        /// @ingroup Window
+        void loop();
+
+        /// @brief Render a single frame, while the application is stopped using noLoop()
+        /// @ingroup Window
+        /// @details This function can be called at any time, also from other event handlers. It has no effect
+        ///          if the application is looping.
+        void redraw();
+
+        /// @brief Check if update() is called continuously
+        /// @ingroup Window
+        /// @return False if noLoop() was called, true otherwise
+        bool isLooping() const;
+
         /// @brief Switch to fullscreen mode
         /// @ingroup Window
         /// @details This function will switch the window to fullscreen mode.
@@ -589,6 +958,14 @@ namespace cppgfx {
         /// @return The distance between the two points
         float dist(float x1, float y1, float x2, float y2);
 
+        /// @brief Linearly interpolate between two values
+        /// @ingroup Math
+        /// @param start The value at amount 0
+        /// @param stop The value at amount 1
+        /// @param amount How far to go from start to stop, usually between 0 and 1
+        /// @return The interpolated value
+        float lerp(float start, float stop, float amount);
+
         /// @brief Convert degrees to radians
         /// @ingroup Math
         /// @param degrees The angle in degrees
@@ -712,6 +1089,62 @@ namespace cppgfx {
 
 
 
+        // =======================================
+        // =====       Threading API      ========
+        // =======================================
+
+        /// @brief Call a function for every index in a range, distributed over all CPU cores
+        /// @ingroup Threading
+        /// @details The range is split into chunks of grain indices, which are processed in parallel by the
+        ///          worker threads and the calling thread. This returns when all indices are done. The function
+        ///          must not call any drawing functions, those can only be used from the thread of the application.
+        ///          Use it to calculate, and draw the results afterwards.
+        /// @param begin The first index
+        /// @param end One past the last index
+        /// @param grain The number of indices per chunk, or 0 to choose it automatically
+        /// @param fn The function to call with every index, e.g. [&](size_t i) { particles[i].move(dt); }
+        template<typename Fn>
+        void parallelFor(size_t begin, size_t end, size_t grain, Fn&& fn)
+        {
+            jobs().parallelFor(begin, end, grain, std::forward<Fn>(fn));
+        }
+
+        /// @brief Run a function on a worker thread
+        /// @ingroup Threading
+        /// @details The function runs in the background while the application continues. All jobs are finished
+        ///          at the latest at the end of update(), so that no job is still running while the frame is drawn.
+        ///          The function must not call any drawing functions.
+        /// @param fn The function to run, it takes no arguments
+        /// @return A task to wait for the function and get its return value with Task::get()
+        template<typename Fn>
+        auto submit(Fn&& fn)
+        {
+            return jobs().submit(std::forward<Fn>(fn), &m_jobGroup);
+        }
+
+        /// @brief Wait until all jobs that were started with submit() are done
+        /// @ingroup Threading
+        /// @details This is done automatically after every update(). While waiting, the calling thread
+        ///          runs jobs itself. Jobs of other applications that share the job system are not waited for.
+        void waitAll();
+
+        /// @brief Get the job system that runs parallelFor() and submit()
+        /// @ingroup Threading
+        /// @details The job system is created on the first use. By default, all applications of the process
+        ///          share one, with one thread less than the CPU has hardware threads, because the thread of the
+        ///          application helps while it waits. If workerThreads is set, this application gets its own.
+        /// @return The job system of this application
+        JobSystem& jobs();
+
+        /// @brief The number of worker threads of a job system for this application only
+        /// @ingroup Threading
+        /// @details If this is 0, the job system that is shared by all applications is used, see jobs(). Set it
+        ///          before the first use of parallelFor() or submit(), e.g. in setup(), to give this application
+        ///          its own workers, for example to run several applications with a fixed share of the cores.
+        size_t workerThreads = 0;
+
+
+
 
         // =======================================
         // =====        Reserved API      ========
@@ -722,37 +1155,145 @@ namespace cppgfx {
         ///          only be called once in the main function, where it should already be in the template.
         void run();
 
+        /// @brief Run the application without a window, to render a sequence of images offline
+        /// @details setup(), update() and cleanup() are called like in run(), but no window is opened and
+        ///          everything is drawn into memory by a SoftwareRenderer of the current width and height. If a
+        ///          SoftwareRenderer was already set with setRenderer(), that one is used. Frames are rendered as
+        ///          fast as possible, without any framerate limit. The time is simulated: every frame advances it
+        ///          by exactly fixedDt, so frameTime, frameCount, millis() and micros() are the same in every run.
+        ///          ImGui can still be used, but nothing of it is drawn. The application stops after the given
+        ///          number of frames, or when close() is called.
+        /// @param frames The number of frames to render
+        /// @param fixedDt The simulated time between two frames in seconds
+        /// @param onFrame Called after every frame with the renderer that contains the finished image
+        void runHeadless(uint64_t frames, float fixedDt, const std::function<void(const SoftwareRenderer&)>& onFrame);
+
+        /// @brief Run the application without a window and save every frame to an image file
+        /// @details This is the same as the other runHeadless() function, but every frame is saved to a file.
+        ///          The filename is formatted with the frame number, e.g. "frames/frame_{:05}.png" gives
+        ///          "frames/frame_00000.png", "frames/frame_00001.png" and so on. All formats supported by
+        ///          sf::Image can be used.
+        /// @param frames The number of frames to render
+        /// @param fixedDt The simulated time between two frames in seconds
+        /// @param path The filename of the images, with a format placeholder for the frame number
+        void runHeadless(uint64_t frames, float fixedDt, const std::string& path);
+
     private:
+        friend class Font;
+
         App(const App&) = delete;
         App& operator=(const App&) = delete;
 
         void updateDisplaySize();
-
-        inline static App* m_instance = nullptr;
+        void handleEvent(const sf::Event& event);
+        bool isIdle();
+        void waitWhileIdle();
+        bool isMinimized();
+        void updateBackgroundState();
+        void applyFrameRateLimit();
+        void updateLineCapCache(float weight, LineCap cap);
+        const std::vector<sf::Vector2f>& unitCircle(size_t segments);
+        void drawShape(const sf::Vector2f* points, size_t count, const sf::Color& fill,
+                       const sf::Color& stroke, float weight);
+
+        inline static thread_local App* m_instance = nullptr;
         bool m_windowShouldClose = false;
 
         sf::Color m_defaultBackgroundColor = sf::Color(60, 60, 60);
         bool m_isDarkTitleBar = false;
         sf::Clock m_lifetimeClock;
+        bool m_headless = false;
+        uint64_t m_simulatedMicros = 0;
+        std::mt19937 m_random;
         sf::Clock m_frametimeClock;
+        sf::Time m_idleTime;
+        bool m_looping = true;
+        uint32_t m_pendingRedraws = 0;
+        float m_frameRateLimit = 60;
+        bool m_inBackground = false;
+        bool m_resumed = false;
+        FramePacer m_pacer;
+        bool m_verticalSync = false;
+
+        // The input state built from the event stream, copied into the public variables before update()
+        sf::Vector2i m_mousePosition;
+        std::bitset<sf::Mouse::ButtonCount> m_mouseButtons;
+        std::bitset<sf::Keyboard::KeyCount> m_keys;
+        void latchInput();
+        void runSimulation(float elapsed);
+        double m_simulationTime = 0;
+
+        std::vector<InputEvent> m_inputEvents;
+        bool m_pendingMouseMove = false;
 
         uint32_t m_widthBeforeFullscreen = 0;
         uint32_t m_heightBeforeFullscreen = 0;
 
-        inline static sf::Font m_defaultFont;
+        sf::Font m_defaultFont;
+
+        // All fonts by handle id, the default font is always the first one. Fonts loaded by the application keep
+        // their file in memory, so that it can be given to renderers that rasterize glyphs themselves.
+        struct LoadedFont {
+            std::vector<uint8_t> file;
+            sf::Font font;
+        };
+        struct FontFile {
+            const uint8_t* data = nullptr;
+            size_t size = 0;
+        };
+        std::vector<const sf::Font*> m_fonts;
+        std::vector<FontFile> m_fontFiles;
+        std::vector<std::unique_ptr<LoadedFont>> m_loadedFonts;
+
+        // Copies of the fonts passed as an sf::Font, by the address they were passed from. sf::Font does not
+        // give access to its file, so a font at a known address is recognized by its family and metrics.
+        struct UserFont {
+            const sf::Font* source = nullptr;
+            std::string family;
+            std::array<float, 4> metrics {};
+            std::unique_ptr<sf::Font> copy;
+            uint32_t id = 0;
+        };
+        std::vector<UserFont> m_userFonts;
+        const sf::Font& getFont(Font font) const;
 
         struct DrawStyle {
             sf::Color m_fillColor = sf::Color::White;
             sf::Color m_strokeColor = sf::Color::Black;
             float m_strokeWeight = 0.f;
-            sf::Font m_font = m_defaultFont;
+            Font m_font;
             uint32_t m_fontSize = 18;
 
             LineCap m_lineCap = LineCap::Round;
             RectMode m_rectMode = RectMode::Corner;
             TextAlign m_textAlign = TextAlign::Left;
         };
-        std::vector<DrawStyle> m_drawStyleStack;
+        FixedStack<DrawStyle, CPPGFX_STYLE_STACK_DEPTH> m_drawStyleStack;
+
+        void drawLine(const DrawStyle& style, float x1, float y1, float x2, float y2);
+        void drawRect(const DrawStyle& style, float x, float y, float w, float h);
+        void drawCircle(const DrawStyle& style, float x, float y, float radius);
+        void drawPoint(const DrawStyle& style, float x, float y);
+        TextStyle textStyle(const DrawStyle& style) const;
+
+        FrameStats m_frameStats;
+        FrameProfiler m_profiler;
+        std::unique_ptr<Renderer> m_renderer;
+        std::vector<sf::Vector2f> m_shapePoints;
+        std::vector<sf::Vector2f> m_outlinePoints;
+
+        struct LineCapCache {
+            float weight = -1.f;
+            LineCap cap = LineCap::Round;
+            std::vector<sf::Vector2f> offsets;
+        };
+        LineCapCache m_lineCapCache;
+        std::vector<std::vector<sf::Vector2f>> m_unitCircles;
+
+        // Declared last, and the destructor waits for the group, so that no job still runs when anything it
+        // might use is destroyed
+        JobGroup m_jobGroup;
+        std::shared_ptr<JobSystem> m_jobs;
 
     };
 
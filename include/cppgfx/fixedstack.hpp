@@ -0,0 +1,37 @@
+#ifndef CPPGFX_FIXEDSTACK_HPP
+#define CPPGFX_FIXEDSTACK_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+namespace cppgfx {
+
+    /// @brief A stack with a fixed capacity which never allocates
+    /// @details The elements are stored inline and cache-line aligned. Since they must be trivially copyable,
+    ///          pushing and popping is as cheap as copying a few bytes. The caller is responsible for checking
+    ///          full() and empty() before push_back() and pop_back().
+    template<typename T, size_t Capacity>
+    class FixedStack {
+        static_assert(std::is_trivially_copyable<T>::value, "FixedStack elements must be trivially copyable");
+        static_assert(Capacity > 0, "FixedStack needs a capacity of at least one element");
+
+    public:
+        T& back() { return m_items[m_size - 1]; }
+        const T& back() const { return m_items[m_size - 1]; }
+
+        void push_back(const T& item) { m_items[m_size++] = item; }
+        void pop_back() { m_size--; }
+
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        bool full() const { return m_size == Capacity; }
+        static constexpr size_t capacity() { return Capacity; }
+
+    private:
+        alignas(64) T m_items[Capacity] {};
+        size_t m_size = 0;
+    };
+
+}
+
+#endif //CPPGFX_FIXEDSTACK_HPP
@@ -0,0 +1,86 @@
+#ifndef CPPGFX_FRAMEPACER_HPP
+#define CPPGFX_FRAMEPACER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace cppgfx {
+
+    /// @brief How precisely the last frames met their deadlines
+    /// @details The lateness of a frame is how long after its deadline the frame loop continued.
+    struct PacingStats {
+        /// @brief The time between two frames that is aimed for in milliseconds, or 0 if the framerate is unlimited
+        double targetFrameTime = 0;
+
+        /// @brief The average lateness in milliseconds
+        double meanLateness = 0;
+
+        /// @brief The 99th percentile of the lateness in milliseconds
+        double p99Lateness = 0;
+
+        /// @brief The largest lateness in milliseconds
+        double maxLateness = 0;
+
+        /// @brief The number of frames that were so late that the next deadline was already due
+        size_t missedDeadlines = 0;
+    };
+
+    /// @brief Limits the framerate by waiting for a schedule of deadlines
+    /// @details Every frame has a deadline, which is exactly one period after the deadline of the previous frame,
+    ///          so rounding errors and late frames do not accumulate and fractional rates like 59.94 are met on
+    ///          average. Waiting is split in two: The thread sleeps until shortly before the deadline and then
+    ///          yields in a loop until the deadline is reached. The margin for the second part adapts to how much
+    ///          the sleep of the operating system overshoots, so the CPU is only busy for a fraction of a
+    ///          millisecond per frame.
+    ///
+    ///          When vertical sync is enabled, presenting the frame already waits for the display. Frames that come
+    ///          back late from the display then move the schedule, instead of being caught up with shorter frames
+    ///          that the display would delay anyway.
+    class FramePacer {
+    public:
+        /// @brief The number of frames that the statistics are calculated from
+        static constexpr size_t HISTORY_SIZE = 240;
+
+        /// @brief Set the target framerate, this restarts the schedule
+        /// @param framesPerSecond The framerate in frames per second, or 0 for no limit
+        void setRate(double framesPerSecond);
+
+        /// @brief Get the target framerate in frames per second, or 0 if there is no limit
+        double getRate() const { return m_rate; }
+
+        /// @brief Tell the pacer if presenting a frame waits for the display
+        void setVerticalSync(bool enabled) { m_verticalSync = enabled; }
+
+        /// @brief Start the schedule from now on, e.g. after the application was idle
+        void reset();
+
+        /// @brief Wait until the deadline of the current frame and advance to the next one
+        void wait();
+
+        /// @brief Calculate the statistics of the last frames
+        PacingStats stats() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        void record(Clock::duration lateness, bool missed);
+
+        double m_rate = 0;
+        bool m_verticalSync = false;
+        Clock::duration m_period {};
+        Clock::time_point m_deadline;
+        bool m_scheduled = false;
+        Clock::duration m_sleepMargin = std::chrono::milliseconds(1);
+
+        std::array<float, HISTORY_SIZE> m_lateness {};
+        std::array<bool, HISTORY_SIZE> m_missed {};
+        size_t m_next = 0;
+        size_t m_count = 0;
+        mutable std::vector<float> m_sorted;
+    };
+
+}
+
+#endif //CPPGFX_FRAMEPACER_HPP
@@ -0,0 +1,93 @@
+#ifndef CPPGFX_FRAMEPROFILER_HPP
+#define CPPGFX_FRAMEPROFILER_HPP
+
+#include "cppgfx/framestats.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace cppgfx {
+
+    /// @brief The parts of a frame that are measured by the FrameProfiler, in the order they happen
+    enum class FramePhase {
+        Events,  // Polling and handling window events
+        Update,  // The user's update() function
+        Flush,   // Submitting the batched primitives
+        ImGui,   // Rendering ImGui
+        Display, // Presenting the frame, including the wait for vsync or the framerate limit
+        Count
+    };
+
+    /// @brief Measures how long every phase of the last frames took
+    /// @details The main loop marks the end of every phase with a high resolution timestamp. The durations of the
+    ///          most recent frames are kept in a ring buffer, from which statistics and an ImGui overlay with a
+    ///          stacked frame time graph are generated.
+    class FrameProfiler {
+    public:
+        /// @brief The number of frames that are kept
+        static constexpr size_t HISTORY_SIZE = 240;
+
+        /// @brief Frame time statistics in milliseconds
+        struct Summary {
+            float min = 0;
+            float avg = 0;
+            float p95 = 0;
+            float p99 = 0;
+            float max = 0;
+        };
+
+        /// @brief Start measuring a new frame
+        void beginFrame();
+
+        /// @brief Mark the end of a phase, everything since the previous mark is counted towards it
+        /// @param phase The phase that just ended
+        void endPhase(FramePhase phase);
+
+        /// @brief Finish the current frame and add it to the history
+        void endFrame();
+
+        /// @brief Get the number of frames in the history
+        size_t frameCount() const { return m_count; }
+
+        /// @brief Get how long a phase took in a frame of the history
+        /// @param frame The index of the frame, where 0 is the oldest frame
+        /// @param phase The phase
+        /// @return The duration in milliseconds
+        float phaseTime(size_t frame, FramePhase phase) const;
+
+        /// @brief Get the total time of a frame in the history
+        /// @param frame The index of the frame, where 0 is the oldest frame
+        /// @return The duration in milliseconds
+        float frameTime(size_t frame) const;
+
+        /// @brief Calculate statistics over the total frame times of the history
+        Summary summary() const;
+
+        /// @brief Draw the overlay with the frame time graph, this must be called within an ImGui frame
+        /// @param stats The rendering statistics to show below the graph
+        void drawOverlay(const FrameStats& stats) const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Frame {
+            std::array<float, static_cast<size_t>(FramePhase::Count)> phases {};
+            float total = 0;
+        };
+
+        const Frame& frame(size_t index) const;
+
+        std::array<Frame, HISTORY_SIZE> m_frames {};
+        size_t m_next = 0;
+        size_t m_count = 0;
+
+        Frame m_current;
+        Clock::time_point m_frameStart;
+        Clock::time_point m_phaseStart;
+        mutable std::vector<float> m_sorted;
+    };
+
+}
+
+#endif //CPPGFX_FRAMEPROFILER_HPP
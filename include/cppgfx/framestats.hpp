@@ -0,0 +1,59 @@
+#ifndef CPPGFX_FRAMESTATS_HPP
+#define CPPGFX_FRAMESTATS_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace cppgfx {
+
+    /// @brief Counters that describe the work done to render one frame
+    /// @details All counters start at 0 at the beginning of every frame.
+    struct FrameStats {
+        /// @brief The number of draw calls that were submitted to the window, excluding ImGui
+        size_t drawCalls = 0;
+
+        /// @brief The number of vertices that were submitted to the window, excluding ImGui
+        size_t vertices = 0;
+
+        /// @brief The number of triangles that were submitted, including the two triangles of every glyph
+        size_t triangles = 0;
+
+        /// @brief How often the bound texture changed between draw calls
+        size_t textureBinds = 0;
+
+        /// @brief The number of calls to App::text()
+        size_t textDraws = 0;
+
+        /// @brief The number of glyphs that were laid out
+        /// @details Text that is found in the text cache is not laid out again, so this only counts the glyphs of
+        ///          text that was drawn for the first time or evicted from the cache.
+        size_t glyphsLaidOut = 0;
+
+        /// @brief The number of calls to App::push()
+        size_t stylePushes = 0;
+
+        /// @brief The number of calls to App::pop()
+        size_t stylePops = 0;
+
+        /// @brief The number of heap allocations that cppgfx made for its buffers and caches
+        /// @details This counts whenever an internal buffer has to grow or a new cache entry is created. Once the
+        ///          buffers are large enough for a scene, this should stay at 0. Allocations made by SFML and ImGui
+        ///          are not included.
+        size_t allocations = 0;
+    };
+
+    /// @brief Count an allocation if a buffer has to grow to hold the given number of elements
+    /// @param buffer The buffer before it is resized or appended to
+    /// @param size The size the buffer will have
+    /// @param stats The stats to count the allocation in
+    template<typename T>
+    void countGrowth(const std::vector<T>& buffer, size_t size, FrameStats& stats)
+    {
+        if (size > buffer.capacity()) {
+            stats.allocations++;
+        }
+    }
+
+}
+
+#endif //CPPGFX_FRAMESTATS_HPP
@@ -0,0 +1,15 @@
+#ifndef CPPGFX_IMCONFIG_HPP
+#define CPPGFX_IMCONFIG_HPP
+
+// ImGui user configuration, which is used when compiling ImGui and everything that includes it.
+// Every App creates its own ImGui context. The current context is thread local, so that applications
+// on different threads do not see each other's context. It is set with IMGUI_SFML_CONFIG_NAME in
+// cmake/deps.cmake and replaces the default config of ImGui-SFML, which is therefore included first.
+
+#include "imconfig-SFML.h"
+
+struct ImGuiContext;
+extern thread_local ImGuiContext* CppgfxImGuiContext;
+#define GImGui CppgfxImGuiContext
+
+#endif //CPPGFX_IMCONFIG_HPP
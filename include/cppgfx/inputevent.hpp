@@ -0,0 +1,20 @@
+#ifndef CPPGFX_INPUTEVENT_HPP
+#define CPPGFX_INPUTEVENT_HPP
+
+#include "SFML/Window.hpp"
+#include <cstdint>
+
+namespace cppgfx {
+
+    /// @brief A keyboard or mouse event together with the time it was received
+    struct InputEvent {
+        /// @brief The event as it was delivered by the window
+        sf::Event event;
+
+        /// @brief When the event was received, in microseconds on the same clock as App::micros()
+        uint64_t timestamp = 0;
+    };
+
+}
+
+#endif //CPPGFX_INPUTEVENT_HPP
@@ -0,0 +1,334 @@
+#ifndef CPPGFX_JOBSYSTEM_HPP
+#define CPPGFX_JOBSYSTEM_HPP
+
+#include "cppgfx/profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace cppgfx {
+
+    class JobSystem;
+
+    /// @brief A handle to a job that was started with JobSystem::submit()
+    /// @details Waiting for a task runs other jobs in the meantime, so jobs can wait for each other without
+    ///          blocking a worker thread. A default constructed task does not refer to a job.
+    template<typename T>
+    class Task {
+    public:
+        Task() = default;
+
+        /// @brief Check if the task refers to a job
+        bool valid() const { return m_state != nullptr; }
+
+        /// @brief Check if the job has finished, without waiting
+        bool isReady() const { return m_state && m_state->done.load(std::memory_order_acquire); }
+
+        /// @brief Wait until the job has finished
+        void wait() const;
+
+        /// @brief Wait until the job has finished and get its result
+        /// @details If the job threw an exception, it is rethrown here. Like std::future::get(), this releases
+        ///          the job, so valid() is false afterwards and the task can not be waited for again.
+        /// @throws std::logic_error If the task has no job, because it was default constructed, moved from, or
+        ///         get() was already called
+        /// @return The return value of the job
+        T get();
+
+    private:
+        friend class JobSystem;
+
+        struct State {
+            JobSystem* system = nullptr;
+            std::atomic<bool> done { false };
+            std::exception_ptr error;
+            std::optional<std::conditional_t<std::is_void_v<T>, std::monostate, T>> value;
+        };
+
+        explicit Task(std::shared_ptr<State> state) : m_state(std::move(state)) {}
+
+        std::shared_ptr<State> m_state;
+    };
+
+    /// @brief A set of jobs that can be waited for together, without waiting for other jobs of the pool
+    /// @details Jobs are added to a group with JobSystem::submit(). The group must outlive its jobs, so wait for
+    ///          it with JobSystem::wait() before it is destroyed.
+    class JobGroup {
+    public:
+        JobGroup() = default;
+
+        JobGroup(const JobGroup&) = delete;
+        JobGroup& operator=(const JobGroup&) = delete;
+
+        /// @brief Check if all jobs of the group have finished, without waiting
+        bool isDone() const { return m_unfinished.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<size_t> m_unfinished { 0 };
+    };
+
+    /// @brief A pool of worker threads that run jobs, with work stealing
+    /// @details Every worker has its own queue. It takes the newest job from its own queue, and when that is empty,
+    ///          it steals the oldest job from another queue, so large pieces of work are split up among idle workers.
+    ///          Jobs that are submitted from outside the pool go to a shared queue, which is run in order.
+    ///
+    ///          A thread that waits for jobs, with Task::wait(), parallelFor(), wait() or waitAll(), runs jobs
+    ///          itself until the work it waits for is done. That is why the pool has one worker less than the
+    ///          hardware has threads by default: The thread of the application is the last worker while it waits.
+    ///          When there is nothing left to run, the waiting thread sleeps after spinning briefly.
+    ///
+    ///          Applications share one pool with the default size, see shared(), so that applications on
+    ///          several threads do not start more workers than there are cores.
+    ///
+    ///          Every job is a zone in the profiler trace, on the thread that ran it.
+    class JobSystem {
+    public:
+        /// @brief Start the worker threads
+        /// @param threads The number of worker threads, or 0 for one less than the hardware concurrency
+        explicit JobSystem(size_t threads = 0);
+
+        /// @brief Wait for all jobs and stop the worker threads
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        /// @brief Get the pool that is shared by the whole process
+        /// @details The pool is created with the default number of workers on the first call, and stopped when
+        ///          the last reference to it is released.
+        /// @return A reference to the shared pool
+        static std::shared_ptr<JobSystem> shared();
+
+        /// @brief Get the number of worker threads
+        size_t threadCount() const { return m_threads.size(); }
+
+        /// @brief Run a function on a worker thread
+        /// @param fn The function to run, it takes no arguments
+        /// @param group The group to add the job to, or nullptr
+        /// @return A task to wait for the function and get its return value
+        template<typename Fn>
+        auto submit(Fn&& fn, JobGroup* group = nullptr) -> Task<std::invoke_result_t<std::decay_t<Fn>&>>;
+
+        /// @brief Call a function for every index in a range, distributed over all threads
+        /// @details The range is split into chunks of grain indices, which the workers and the calling thread
+        ///          take one after another until none are left, so chunks that take longer are balanced out.
+        ///          This returns when all indices are done. If the function throws, the remaining chunks are
+        ///          skipped and the first exception is rethrown here.
+        /// @param begin The first index
+        /// @param end One past the last index
+        /// @param grain The number of indices per chunk, or 0 to choose it from the size of the range
+        /// @param fn The function to call with every index
+        template<typename Fn>
+        void parallelFor(size_t begin, size_t end, size_t grain, Fn&& fn);
+
+        /// @brief Wait until all jobs of a group are done, including jobs that were added while waiting
+        /// @details Do not call this from inside a job of the same group, it would wait for itself.
+        void wait(const JobGroup& group);
+
+        /// @brief Wait until all submitted jobs are done, including jobs that were submitted while waiting
+        /// @details This includes the jobs of everyone else who uses the pool. Do not call this from inside
+        ///          a job, it would wait for itself.
+        void waitAll();
+
+    private:
+        template<typename T> friend class Task;
+
+        struct Job {
+            virtual ~Job() = default;
+            virtual void run() = 0;
+        };
+
+        template<typename Fn>
+        struct FunctionJob : Job {
+            explicit FunctionJob(Fn function) : fn(std::move(function)) {}
+            void run() override { fn(); }
+            Fn fn;
+        };
+
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::unique_ptr<Job>> jobs;
+        };
+
+        template<typename Fn>
+        void push(Fn&& fn)
+        {
+            pushJob(std::make_unique<FunctionJob<std::decay_t<Fn>>>(std::forward<Fn>(fn)));
+        }
+
+        void pushJob(std::unique_ptr<Job> job);
+        bool runOne();
+        size_t queueIndex() const;
+        void workerLoop(size_t index);
+
+        // Run jobs until the condition is met. Spinning briefly catches jobs that are about to finish, afterwards
+        // the thread sleeps until a job is queued or finished, since either can be what it waits for.
+        template<typename Condition>
+        void helpUntil(Condition done)
+        {
+            constexpr size_t SPINS = 64;
+            size_t idle = 0;
+            while (!done()) {
+                if (runOne()) {
+                    idle = 0;
+                }
+                else if (idle < SPINS) {
+                    idle++;
+                    std::this_thread::yield();
+                }
+                else {
+                    // Pairs with the fence in runOne(): either the job sees the waiter, or the waiter sees the job
+                    std::unique_lock<std::mutex> lock(m_sleepMutex);
+                    m_waiters.fetch_add(1, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    m_progress.wait(lock, [&] { return done() || m_queued.load(std::memory_order_acquire) > 0; });
+                    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+                    idle = 0;
+                }
+            }
+        }
+
+        // The first queue is shared by all threads that are not workers, the others belong to one worker each
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::vector<std::thread> m_threads;
+        std::atomic<size_t> m_queued { 0 };
+        std::atomic<size_t> m_unfinished { 0 };
+
+        std::mutex m_sleepMutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_progress;
+        std::atomic<size_t> m_waiters { 0 };
+        bool m_stop = false;
+    };
+
+    template<typename T>
+    void Task<T>::wait() const
+    {
+        if (m_state) {
+            m_state->system->helpUntil([this] { return isReady(); });
+        }
+    }
+
+    template<typename T>
+    T Task<T>::get()
+    {
+        if (!valid()) {
+            throw std::logic_error("[cppgfx]: Task::get() was called on a task without a job");
+        }
+        wait();
+        std::shared_ptr<State> state = std::move(m_state);
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(*state->value);
+        }
+    }
+
+    template<typename Fn>
+    auto JobSystem::submit(Fn&& fn, JobGroup* group) -> Task<std::invoke_result_t<std::decay_t<Fn>&>>
+    {
+        using Result = std::invoke_result_t<std::decay_t<Fn>&>;
+        auto state = std::make_shared<typename Task<Result>::State>();
+        state->system = this;
+        if (group) {
+            group->m_unfinished.fetch_add(1, std::memory_order_relaxed);
+        }
+        push([state, group, fn = std::forward<Fn>(fn)]() mutable {
+            try {
+                if constexpr (std::is_void_v<Result>) {
+                    fn();
+                    state->value.emplace();
+                }
+                else {
+                    state->value.emplace(fn());
+                }
+            }
+            catch (...) {
+                state->error = std::current_exception();
+            }
+            state->done.store(true, std::memory_order_release);
+            if (group) {
+                group->m_unfinished.fetch_sub(1, std::memory_order_release);
+            }
+        });
+        return Task<Result>(state);
+    }
+
+    template<typename Fn>
+    void JobSystem::parallelFor(size_t begin, size_t end, size_t grain, Fn&& fn)
+    {
+        if (end <= begin) {
+            return;
+        }
+        size_t count = end - begin;
+        if (grain == 0) {
+            // A few chunks per thread, so that the workers can balance uneven chunks
+            grain = std::max<size_t>(1, count / ((threadCount() + 1) * 4));
+        }
+        size_t chunks = (count + grain - 1) / grain;
+
+        struct Shared {
+            std::atomic<size_t> nextChunk { 0 };
+            std::atomic<size_t> activeJobs { 0 };
+            std::mutex errorMutex;
+            std::exception_ptr error;
+        };
+        Shared shared;
+
+        auto runChunks = [&shared, &fn, begin, end, grain, chunks]() {
+            CPPGFX_PROFILE_SCOPE("parallelFor");
+            for (size_t chunk = shared.nextChunk++; chunk < chunks; chunk = shared.nextChunk++) {
+                size_t first = begin + chunk * grain;
+                size_t last = std::min(end, first + grain);
+                try {
+                    for (size_t i = first; i < last; i++) {
+                        fn(i);
+                    }
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(shared.errorMutex);
+                    if (!shared.error) {
+                        shared.error = std::current_exception();
+                    }
+                    shared.nextChunk = chunks;
+                }
+            }
+        };
+
+        // The helpers refer to this stack frame, so this waits until every helper has returned, also the
+        // ones that only start when all chunks are already taken
+        size_t helpers = std::min(chunks - 1, threadCount());
+        shared.activeJobs = helpers;
+        for (size_t i = 0; i < helpers; i++) {
+            push([&shared, &runChunks]() {
+                runChunks();
+                shared.activeJobs.fetch_sub(1, std::memory_order_release);
+            });
+        }
+        runChunks();
+        helpUntil([&shared] { return shared.activeJobs.load(std::memory_order_acquire) == 0; });
+
+        if (shared.error) {
+            std::rethrow_exception(shared.error);
+        }
+    }
+
+}
+
+#endif //CPPGFX_JOBSYSTEM_HPP
@@ -0,0 +1,47 @@
+#ifndef CPPGFX_LAZYWINDOW_HPP
+#define CPPGFX_LAZYWINDOW_HPP
+
+#include "SFML/Graphics.hpp"
+#include <new>
+
+namespace cppgfx {
+
+    /// @brief Storage for an sf::RenderWindow which is only constructed when it is first needed
+    /// @details SFML needs a display as soon as an sf::RenderWindow is constructed, even while it is closed.
+    ///          The storage exists from the start, so a reference to the window can be handed out before the
+    ///          window itself is constructed. That reference must not be used until create() was called.
+    class LazyWindow {
+    public:
+        LazyWindow() = default;
+        LazyWindow(const LazyWindow&) = delete;
+        LazyWindow& operator=(const LazyWindow&) = delete;
+        ~LazyWindow() {
+            if (m_window) {
+                m_window->~RenderWindow();
+            }
+        }
+
+        /// @brief Construct the window, unless it already exists
+        /// @return The window
+        sf::RenderWindow& create() {
+            if (!m_window) {
+                m_window = new (m_storage) sf::RenderWindow();
+            }
+            return *m_window;
+        }
+
+        /// @brief Get the place of the window, which is valid to refer to even before create()
+        sf::RenderWindow& storage() { return *reinterpret_cast<sf::RenderWindow*>(m_storage); }
+
+        explicit operator bool() const { return m_window != nullptr; }
+        sf::RenderWindow* operator->() const { return m_window; }
+        sf::RenderWindow& operator*() const { return *m_window; }
+
+    private:
+        alignas(sf::RenderWindow) unsigned char m_storage[sizeof(sf::RenderWindow)];
+        sf::RenderWindow* m_window = nullptr;
+    };
+
+}
+
+#endif //CPPGFX_LAZYWINDOW_HPP
@@ -0,0 +1,63 @@
+#ifndef CPPGFX_PROFILER_HPP
+#define CPPGFX_PROFILER_HPP
+
+#include <cstdint>
+#include <ostream>
+
+#ifndef CPPGFX_PROFILER_BUFFER_SIZE
+#define CPPGFX_PROFILER_BUFFER_SIZE 65536
+#endif
+
+namespace cppgfx {
+
+    /// @brief Get the current time of the profiler clock
+    /// @return A monotonic timestamp in nanoseconds
+    int64_t profilerTimestamp();
+
+    /// @brief Record a finished zone on the current thread
+    /// @details Every thread records into its own buffer, so this never blocks. Each buffer keeps the last
+    ///          CPPGFX_PROFILER_BUFFER_SIZE zones, older zones are overwritten.
+    /// @param name The name of the zone, which must stay valid until the trace is written (e.g. a string literal)
+    /// @param begin The timestamp when the zone started, from profilerTimestamp()
+    /// @param end The timestamp when the zone ended, from profilerTimestamp()
+    void profilerRecord(const char* name, int64_t begin, int64_t end);
+
+    /// @brief Write all recorded zones of all threads in the Chrome trace event format
+    /// @details The output can be opened in chrome://tracing or https://ui.perfetto.dev
+    /// @param out The stream to write the JSON to
+    void profilerWriteTrace(std::ostream& out);
+
+    /// @brief Discard all recorded zones of all threads
+    void profilerClear();
+
+    /// @brief Records the time between its construction and destruction as a zone
+    /// @details Use the CPPGFX_PROFILE_SCOPE macro instead of this class, so that the zone is removed
+    ///          when the profiler is disabled.
+    class ProfileScope {
+    public:
+        explicit ProfileScope(const char* name) : m_name(name), m_begin(profilerTimestamp()) {}
+        ~ProfileScope() { profilerRecord(m_name, m_begin, profilerTimestamp()); }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        const char* m_name;
+        int64_t m_begin;
+    };
+
+}
+
+#define CPPGFX_PROFILE_CONCAT_IMPL(a, b) a##b
+#define CPPGFX_PROFILE_CONCAT(a, b) CPPGFX_PROFILE_CONCAT_IMPL(a, b)
+
+/// @brief Measure the rest of the enclosing scope as a named zone in the trace
+/// @details Zones can be nested and used on any thread. The name must be a string literal.
+///          When cppgfx is built without USE_PROFILER, this expands to nothing.
+#ifdef CPPGFX_PROFILER
+#define CPPGFX_PROFILE_SCOPE(name) ::cppgfx::ProfileScope CPPGFX_PROFILE_CONCAT(cppgfxProfileScope, __LINE__)(name)
+#else
+#define CPPGFX_PROFILE_SCOPE(name) ((void)0)
+#endif
+
+#endif //CPPGFX_PROFILER_HPP
@@ -0,0 +1,105 @@
+#ifndef CPPGFX_RENDERER_HPP
+#define CPPGFX_RENDERER_HPP
+
+#include "SFML/Graphics.hpp"
+#include "cppgfx/framestats.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace cppgfx {
+
+    /// @brief Everything that is needed to lay out and draw a string
+    struct TextStyle {
+        const sf::Font* font = nullptr;
+        uint32_t fontId = 0;
+        uint32_t characterSize = 0;
+        float outlineThickness = 0;
+        sf::Color fillColor;
+        sf::Color outlineColor;
+
+        // The TrueType file of the font, for renderers that rasterize glyphs themselves. It is nullptr when the
+        // file is not known, e.g. for an sf::Font that was loaded by the user.
+        const uint8_t* fontData = nullptr;
+        size_t fontDataSize = 0;
+    };
+
+    /// @brief The backend that all drawing functions of the App go to
+    /// @details The App tessellates all shapes into a few basic primitives, which a renderer then draws in any way
+    ///          it likes. Renderers may collect primitives and draw them later, so flush() must be called before
+    ///          the result is used.
+    class Renderer {
+    public:
+        Renderer() = default;
+        virtual ~Renderer() = default;
+
+        Renderer(const Renderer&) = delete;
+        Renderer& operator=(const Renderer&) = delete;
+
+        /// @brief Set the counters that the renderer adds its work to
+        /// @param stats The counters, or nullptr to not count anything
+        void setStats(FrameStats* stats) { m_stats = stats ? stats : &m_unusedStats; }
+
+        /// @brief Discard all pending primitives and clear the render target
+        /// @param color The color to clear the target with
+        virtual void clear(const sf::Color& color) = 0;
+
+        /// @brief Discard all pending primitives without drawing them
+        virtual void discard() = 0;
+
+        /// @brief Fill a convex polygon
+        /// @param points The corners of the polygon, in order
+        /// @param count The number of corners
+        /// @param color The fill color
+        virtual void convex(const sf::Vector2f* points, size_t count, const sf::Color& color) = 0;
+
+        /// @brief Fill a triangle strip
+        /// @details Every point forms a triangle with the two points before it.
+        /// @param points The points of the strip
+        /// @param count The number of points
+        /// @param color The fill color
+        virtual void strip(const sf::Vector2f* points, size_t count, const sf::Color& color) = 0;
+
+        /// @brief Fill the band between two closed outlines
+        /// @details Both outlines must have the same number of points, where outer[i] corresponds to inner[i].
+        ///          This is used for the outlines of shapes.
+        /// @param outer The points of the outer outline
+        /// @param inner The points of the inner outline
+        /// @param count The number of points in each outline
+        /// @param color The fill color
+        virtual void ring(const sf::Vector2f* outer, const sf::Vector2f* inner, size_t count,
+                          const sf::Color& color) = 0;
+
+        /// @brief Draw a string, with the outline below the fill
+        /// @param text The string to draw
+        /// @param position The top of the bounds of the string, and the point it is aligned to horizontally
+        /// @param align Which part of the string is at position.x: 0 for the left, 0.5 for the center, 1 for the right
+        /// @param style The font, size and colors of the string
+        virtual void text(const std::string& text, const sf::Vector2f& position, float align,
+                          const TextStyle& style) = 0;
+
+        /// @brief Measure the widths of many strings, ignoring the outline
+        /// @param texts The strings to measure
+        /// @param count The number of strings
+        /// @param style The font and size of the strings
+        /// @param widths Receives the width of every string in pixels, must have room for count elements
+        virtual void textWidths(const std::string* texts, size_t count, const TextStyle& style, float* widths) = 0;
+
+        /// @brief Draw all pending primitives
+        virtual void flush() = 0;
+
+        /// @brief Drop everything cached for a font, because its id now refers to another font
+        /// @details Pending primitives must be flushed first, they may still use the old font.
+        /// @param fontId The id of the font, as in TextStyle::fontId
+        virtual void forgetFont(uint32_t fontId) {}
+
+    protected:
+        FrameStats* m_stats = &m_unusedStats;
+
+    private:
+        FrameStats m_unusedStats;
+    };
+
+}
+
+#endif //CPPGFX_RENDERER_HPP
@@ -0,0 +1,59 @@
+#ifndef CPPGFX_SFMLRENDERER_HPP
+#define CPPGFX_SFMLRENDERER_HPP
+
+#include "SFML/Graphics.hpp"
+#include "cppgfx/renderer.hpp"
+#include "cppgfx/textcache.hpp"
+#include "cppgfx/textmetrics.hpp"
+#include <vector>
+
+namespace cppgfx {
+
+    /// @brief Draws to an SFML render target in as few draw calls as possible
+    /// @details Primitives are tessellated into triangles and appended to one growing vertex array. The array is
+    ///          only submitted to the render target when the render state changes, or when flush() is called
+    ///          explicitly (before ImGui is rendered and before the window is displayed). The vertex storage is
+    ///          kept across frames, so that a steady-state frame does not allocate.
+    ///
+    ///          Shapes are drawn with the texture coordinates of the white texel that every SFML font page reserves
+    ///          at (0, 0). Shapes therefore never change the bound texture, and text with the same font and
+    ///          character size ends up in the same draw call as the shapes around it, in painter's order.
+    class SfmlRenderer : public Renderer {
+    public:
+        explicit SfmlRenderer(sf::RenderTarget& target);
+
+        void clear(const sf::Color& color) override;
+        void discard() override;
+        void convex(const sf::Vector2f* points, size_t count, const sf::Color& color) override;
+        void strip(const sf::Vector2f* points, size_t count, const sf::Color& color) override;
+        void ring(const sf::Vector2f* outer, const sf::Vector2f* inner, size_t count,
+                  const sf::Color& color) override;
+        void text(const std::string& text, const sf::Vector2f& position, float align,
+                  const TextStyle& style) override;
+        void textWidths(const std::string* texts, size_t count, const TextStyle& style, float* widths) override;
+        void flush() override;
+        void forgetFont(uint32_t fontId) override;
+
+    private:
+        sf::Vertex* allocate(size_t count);
+        void setTexture(const sf::Texture* texture);
+        void glyphs(const sf::Vertex* vertices,
+                    size_t count,
+                    const sf::Vector2f& offset,
+                    const sf::Color& color,
+                    const sf::Texture& texture);
+
+        sf::RenderTarget& m_target;
+        sf::RenderStates m_states;
+        std::vector<sf::Vertex> m_vertices;
+        bool m_pendingGlyphs = false;
+
+        // Enough for the labels of a large dashboard, without cycling through the cache every frame
+        static constexpr size_t TEXT_CACHE_SIZE = 8192;
+        TextCache m_textCache { TEXT_CACHE_SIZE };
+        TextMetrics m_textMetrics;
+    };
+
+}
+
+#endif //CPPGFX_SFMLRENDERER_HPP
@@ -0,0 +1,90 @@
+#ifndef CPPGFX_SOFTWAREBLEND_HPP
+#define CPPGFX_SOFTWAREBLEND_HPP
+
+#include "SFML/Graphics.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CPPGFX_SOFTWARE_SSE2
+#include <emmintrin.h>
+#endif
+
+// The pixel blending of the SoftwareRenderer. It is in a header of its own, so that the vector path can be
+// tested against the scalar path.
+
+namespace cppgfx::software {
+
+    /// @brief Rounded division by 255, exact for every sum of two products of 8 bit values up to 255 * 255
+    inline uint32_t div255(uint32_t x)
+    {
+        x += 128;
+        return (x + (x >> 8)) >> 8;
+    }
+
+    /// @brief Pack a color into an RGBA pixel in memory order
+    inline uint32_t pack(const sf::Color& color)
+    {
+        uint8_t bytes[4] = { color.r, color.g, color.b, color.a };
+        uint32_t pixel;
+        std::memcpy(&pixel, bytes, sizeof(pixel));
+        return pixel;
+    }
+
+    /// @brief Blend a color into a pixel like sf::BlendAlpha, with 8 bit integers
+    /// @details The color channels are blended with SrcAlpha and OneMinusSrcAlpha, the alpha channel with One and
+    ///          OneMinusSrcAlpha.
+    /// @param pixel The RGBA pixel to blend into
+    /// @param color The color to blend, its alpha is ignored
+    /// @param alpha The alpha to blend with, which already includes the coverage
+    inline void blendPixel(uint32_t& pixel, const sf::Color& color, uint32_t alpha)
+    {
+        uint8_t bytes[4];
+        std::memcpy(bytes, &pixel, sizeof(pixel));
+        uint32_t inverse = 255 - alpha;
+        bytes[0] = static_cast<uint8_t>(div255(color.r * alpha + bytes[0] * inverse));
+        bytes[1] = static_cast<uint8_t>(div255(color.g * alpha + bytes[1] * inverse));
+        bytes[2] = static_cast<uint8_t>(div255(color.b * alpha + bytes[2] * inverse));
+        bytes[3] = static_cast<uint8_t>(div255(255 * alpha + bytes[3] * inverse));
+        std::memcpy(&pixel, bytes, sizeof(pixel));
+    }
+
+    /// @brief Blend a span of pixels with the same alpha, four pixels at a time where possible
+    /// @details The vector path computes exactly the same values as blendPixel().
+    inline void blendSpan(uint32_t* pixels, size_t count, const sf::Color& color, uint32_t alpha)
+    {
+        if (alpha == 255) {
+            std::fill_n(pixels, count, pack(color));
+            return;
+        }
+
+        size_t i = 0;
+#ifdef CPPGFX_SOFTWARE_SSE2
+        auto lane = [](uint32_t value) { return static_cast<short>(static_cast<uint16_t>(value)); };
+        __m128i source = _mm_setr_epi16(lane(color.r * alpha), lane(color.g * alpha), lane(color.b * alpha),
+                                        lane(255 * alpha), lane(color.r * alpha), lane(color.g * alpha),
+                                        lane(color.b * alpha), lane(255 * alpha));
+        __m128i inverse = _mm_set1_epi16(lane(255 - alpha));
+        __m128i bias = _mm_set1_epi16(128);
+        __m128i zero = _mm_setzero_si128();
+        for (; i + 4 <= count; i += 4) {
+            __m128i destination = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+            __m128i low = _mm_unpacklo_epi8(destination, zero);
+            __m128i high = _mm_unpackhi_epi8(destination, zero);
+            low = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(low, inverse), source), bias);
+            high = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(high, inverse), source), bias);
+            low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+            high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), _mm_packus_epi16(low, high));
+        }
+#endif
+        for (; i < count; i++) {
+            blendPixel(pixels[i], color, alpha);
+        }
+    }
+
+}
+
+#endif //CPPGFX_SOFTWAREBLEND_HPP
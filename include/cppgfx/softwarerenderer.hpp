@@ -0,0 +1,107 @@
+#ifndef CPPGFX_SOFTWARERENDERER_HPP
+#define CPPGFX_SOFTWARERENDERER_HPP
+
+#include "SFML/Graphics.hpp"
+#include "cppgfx/renderer.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cppgfx {
+
+    /// @brief Draws into an RGBA image in memory on the CPU, without OpenGL
+    /// @details Every primitive is rasterized scanline by scanline with exact analytic area coverage for
+    ///          anti-aliasing, and blended with the same equation as sf::BlendAlpha. Fully covered spans are filled
+    ///          several pixels at a time. Only integer arithmetic is used for blending, so the same drawing
+    ///          always produces the same pixels on every machine, which makes the output suited for comparisons.
+    ///
+    ///          Glyphs are rasterized from the TrueType file of the selected font (TextStyle::fontData). Fonts
+    ///          without a known file, like an sf::Font passed to App::textFont(), are drawn with the embedded
+    ///          Roboto font instead.
+    class SoftwareRenderer : public Renderer {
+    public:
+        SoftwareRenderer(uint32_t width, uint32_t height);
+        ~SoftwareRenderer() override;
+
+        /// @brief Change the size of the image, which clears it to transparent black
+        /// @param width The new width in pixels
+        /// @param height The new height in pixels
+        void resize(uint32_t width, uint32_t height);
+
+        /// @brief Get the width of the image in pixels
+        uint32_t getWidth() const { return m_width; }
+
+        /// @brief Get the height of the image in pixels
+        uint32_t getHeight() const { return m_height; }
+
+        /// @brief Get the pixels of the image
+        /// @return The RGBA pixels row by row, starting at the top left, with 4 bytes per pixel
+        const uint8_t* getPixels() const;
+
+        /// @brief Copy the pixels into an sf::Image, which can be saved to a file
+        sf::Image toImage() const;
+
+        void clear(const sf::Color& color) override;
+        void discard() override;
+        void convex(const sf::Vector2f* points, size_t count, const sf::Color& color) override;
+        void strip(const sf::Vector2f* points, size_t count, const sf::Color& color) override;
+        void ring(const sf::Vector2f* outer, const sf::Vector2f* inner, size_t count,
+                  const sf::Color& color) override;
+        void text(const std::string& text, const sf::Vector2f& position, float align,
+                  const TextStyle& style) override;
+        void textWidths(const std::string* texts, size_t count, const TextStyle& style, float* widths) override;
+        void flush() override;
+
+    private:
+        struct Edge {
+            sf::Vector2f from;
+            sf::Vector2f to;
+        };
+
+        struct Glyph {
+            int left = 0;
+            int top = 0;
+            int width = 0;
+            int height = 0;
+            float advance = 0;
+            std::vector<uint8_t> coverage;
+        };
+
+        struct PlacedGlyph {
+            const Glyph* glyph;
+            const Glyph* outline;
+            sf::Vector2f position;
+        };
+
+        struct FontInfo;
+
+        void addEdge(const sf::Vector2f& from, const sf::Vector2f& to);
+        void addTriangle(const sf::Vector2f& a, const sf::Vector2f& b, const sf::Vector2f& c);
+        void fillPath(const sf::Color& color);
+        void accumulateLine(sf::Vector2f from, sf::Vector2f to, float* accumulation, size_t stride, int rows);
+        void blendRow(uint32_t* pixels, const uint8_t* coverage, size_t count, const sf::Color& color);
+        void blitGlyph(const Glyph& glyph, const sf::Vector2f& position, const sf::Color& color);
+
+        FontInfo& font(const TextStyle& style);
+        sf::FloatRect layout(FontInfo& font, const std::string& text, uint32_t characterSize, float outlineThickness);
+        const Glyph& glyph(FontInfo& font, uint32_t codepoint, uint32_t characterSize, float outlineThickness);
+        float kerning(const FontInfo& font, uint32_t first, uint32_t second, uint32_t characterSize);
+
+        uint32_t m_width = 0;
+        uint32_t m_height = 0;
+        std::vector<uint32_t> m_pixels;
+
+        std::vector<Edge> m_edges;
+        std::vector<float> m_accumulation;
+        std::vector<uint8_t> m_coverage;
+
+        // By the address of the font file
+        std::unordered_map<const uint8_t*, std::unique_ptr<FontInfo>> m_fonts;
+        std::vector<PlacedGlyph> m_placedGlyphs;
+    };
+
+}
+
+#endif //CPPGFX_SOFTWARERENDERER_HPP
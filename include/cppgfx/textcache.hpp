@@ -0,0 +1,74 @@
+#ifndef CPPGFX_TEXTCACHE_HPP
+#define CPPGFX_TEXTCACHE_HPP
+
+#include "SFML/Graphics.hpp"
+#include "cppgfx/framestats.hpp"
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cppgfx {
+
+    /// @brief The laid out glyph quads of a string, relative to the text origin
+    /// @details This is the same geometry that sf::Text would generate. The vertex colors are not set, they are
+    ///          applied when the text is drawn. The outline quads come first, followed by the fill quads.
+    struct TextLayout {
+        std::vector<sf::Vertex> vertices;
+        size_t outlineVertexCount = 0;
+        sf::FloatRect bounds;
+    };
+
+    /// @brief Keeps the layout of recently drawn strings across frames
+    /// @details Entries are identified by the string, the font, the character size and the outline thickness.
+    ///          When the cache is full, the least recently used entry is evicted and its memory is reused.
+    class TextCache {
+    public:
+        explicit TextCache(size_t capacity);
+
+        /// @brief Get the layout of a string, laying it out only if it is not cached yet
+        /// @param text The string to lay out
+        /// @param font The font to use
+        /// @param fontId An identifier which is unique for the font
+        /// @param characterSize The character size in pixels
+        /// @param outlineThickness The outline thickness in pixels, or 0 for no outline
+        /// @param stats Counts the glyphs that had to be laid out and the allocations for new entries
+        /// @return The cached layout, which stays valid until the next call
+        const TextLayout& get(const std::string& text,
+                              const sf::Font& font,
+                              uint32_t fontId,
+                              uint32_t characterSize,
+                              float outlineThickness,
+                              FrameStats& stats);
+
+        /// @brief Drop all layouts of a font, because its id now refers to another font
+        /// @param fontId The identifier of the font
+        void forget(uint32_t fontId);
+
+    private:
+        struct Entry {
+            std::string text;
+            uint32_t fontId = 0;
+            uint32_t characterSize = 0;
+            float outlineThickness = 0;
+            uint64_t hash = 0;
+            TextLayout layout;
+        };
+
+        void build(TextLayout& layout,
+                   const std::string& text,
+                   const sf::Font& font,
+                   uint32_t characterSize,
+                   float outlineThickness,
+                   FrameStats& stats);
+
+        size_t m_capacity;
+        std::list<Entry> m_entries; // Most recently used first
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> m_index;
+        std::vector<sf::Vertex> m_fillVertices;
+    };
+
+}
+
+#endif //CPPGFX_TEXTCACHE_HPP
@@ -0,0 +1,68 @@
+#ifndef CPPGFX_TEXTMETRICS_HPP
+#define CPPGFX_TEXTMETRICS_HPP
+
+#include "SFML/Graphics.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cppgfx {
+
+    /// @brief Measures strings without laying them out
+    /// @details For every font and character size, the horizontal metrics of the ASCII characters and the kerning
+    ///          between them are looked up once and kept in tables. Measuring an ASCII string then only needs
+    ///          table lookups, other characters are looked up in the font directly. The result is exactly the
+    ///          width of the local bounds of an sf::Text with the same string, font and character size.
+    class TextMetrics {
+    public:
+        /// @brief Measure the width of a string in pixels
+        /// @param text The string to measure
+        /// @param font The font to use
+        /// @param fontId An identifier which is unique for the font
+        /// @param characterSize The character size in pixels
+        /// @return The width of the string in pixels
+        float width(const std::string& text, const sf::Font& font, uint32_t fontId, uint32_t characterSize);
+
+        /// @brief Measure the widths of many strings with the same font and character size
+        /// @param texts The strings to measure
+        /// @param count The number of strings
+        /// @param font The font to use
+        /// @param fontId An identifier which is unique for the font
+        /// @param characterSize The character size in pixels
+        /// @param widths Receives the width of every string, must have room for count elements
+        void widths(const std::string* texts,
+                    size_t count,
+                    const sf::Font& font,
+                    uint32_t fontId,
+                    uint32_t characterSize,
+                    float* widths);
+
+        /// @brief Drop the tables of a font, because its id now refers to another font
+        /// @param fontId The identifier of the font
+        void forget(uint32_t fontId);
+
+    private:
+        static constexpr uint32_t ASCII_COUNT = 128;
+
+        // Whitespace is stored like a glyph without ink, so that every character is measured the same way.
+        // Kerning pairs are empty until they are looked up for the first time.
+        struct Table {
+            float advance[ASCII_COUNT] {};
+            float left[ASCII_COUNT] {};
+            float right[ASCII_COUNT] {};
+            std::vector<std::optional<float>> kerning;
+        };
+
+        Table& table(const sf::Font& font, uint32_t fontId, uint32_t characterSize);
+
+        template<typename Char>
+        float measure(const Char* chars, size_t count, Table& table, const sf::Font& font, uint32_t characterSize);
+
+        std::unordered_map<uint64_t, Table> m_tables;
+    };
+
+}
+
+#endif //CPPGFX_TEXTMETRICS_HPP
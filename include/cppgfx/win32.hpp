@@ -10,6 +10,8 @@ namespace cppgfx {
 
     void Win32EnableDarkTitleBar(sf::WindowHandle handle, bool darkTitleBar);
 
+    bool Win32IsMinimized(sf::WindowHandle handle);
+
 }
 
 #endif // _WIN32
@@ -6,38 +6,122 @@
 #include "cppgfx/win32.hpp"
 
 #include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+
+// See cppgfx/imconfig.hpp
+thread_local ImGuiContext* CppgfxImGuiContext = nullptr;
 
 namespace cppgfx {
 
 App::App()
+    : window(m_window.storage())
 {
     m_instance = this;
     if (!m_defaultFont.loadFromMemory(ROBOTO_MEDIUM_DATA, ROBOTO_MEDIUM_SIZE)) {
         throw std::runtime_error(
             "[cppgfx]: Failed to load SFML default font: Roboto Medium");
     }
-    m_drawStyleStack.emplace_back();
+    m_fonts.push_back(&m_defaultFont);
+    m_fontFiles.push_back({ ROBOTO_MEDIUM_DATA, ROBOTO_MEDIUM_SIZE });
+    m_drawStyleStack.push_back(DrawStyle());
+}
+
+App::~App()
+{
+    waitAll();
+    if (m_instance == this) {
+        m_instance = nullptr;
+    }
 }
 
-App::~App() = default;
+Font::operator const sf::Font&() const
+{
+    return App::Get().getFont(*this);
+}
 
 // =======================================
 // =====        Graphics API      ========
 // =======================================
 
+// The maximum distance in pixels between a tessellated arc and the real arc
+static constexpr float ARC_TOLERANCE = 0.25f;
+
+// The number of segments needed to approximate an arc with the given radius and angle
+static size_t arcSegments(float radius, float angle)
+{
+    if (radius <= ARC_TOLERANCE) {
+        return 1;
+    }
+    float segmentAngle = 2.0f * acosf(1.0f - ARC_TOLERANCE / radius);
+    return std::clamp<size_t>(static_cast<size_t>(ceilf(angle / segmentAngle)), 1, 256);
+}
+
+// Circles use between MIN and MAX segments, in steps of 4 so that few unit tables are needed
+static constexpr size_t MIN_CIRCLE_SEGMENTS = 8;
+static constexpr size_t MAX_CIRCLE_SEGMENTS = 256;
+
+static size_t circleSegments(float radius)
+{
+    size_t segments = (arcSegments(std::abs(radius), 2.0f * App::PI) + 3) / 4 * 4;
+    return std::clamp(segments, MIN_CIRCLE_SEGMENTS, MAX_CIRCLE_SEGMENTS);
+}
+
+// Offset every corner of a convex polygon outwards by the given thickness, the same way sf::Shape does it
+static void computeOutline(const sf::Vector2f* points, size_t count, float thickness, sf::Vector2f* outline)
+{
+    sf::Vector2f min = points[0];
+    sf::Vector2f max = points[0];
+    for (size_t i = 1; i < count; i++) {
+        min = { std::min(min.x, points[i].x), std::min(min.y, points[i].y) };
+        max = { std::max(max.x, points[i].x), std::max(max.y, points[i].y) };
+    }
+    sf::Vector2f center = { (min.x + max.x) / 2.0f, (min.y + max.y) / 2.0f };
+
+    auto normalOf = [](const sf::Vector2f& p1, const sf::Vector2f& p2) {
+        sf::Vector2f normal = { p1.y - p2.y, p2.x - p1.x };
+        float length = sqrtf(normal.x * normal.x + normal.y * normal.y);
+        if (length != 0.f) {
+            normal = { normal.x / length, normal.y / length };
+        }
+        return normal;
+    };
+
+    for (size_t i = 0; i < count; i++) {
+        const sf::Vector2f& p0 = points[(i == 0) ? count - 1 : i - 1];
+        const sf::Vector2f& p1 = points[i];
+        const sf::Vector2f& p2 = points[(i + 1 == count) ? 0 : i + 1];
+
+        // Make sure that the normals point towards the outside of the shape
+        sf::Vector2f n1 = normalOf(p0, p1);
+        sf::Vector2f n2 = normalOf(p1, p2);
+        if (n1.x * (center.x - p1.x) + n1.y * (center.y - p1.y) > 0) {
+            n1 = { -n1.x, -n1.y };
+        }
+        if (n2.x * (center.x - p1.x) + n2.y * (center.y - p1.y) > 0) {
+            n2 = { -n2.x, -n2.y };
+        }
+
+        float factor = 1.f + (n1.x * n2.x + n1.y * n2.y);
+        outline[i] = { p1.x + (n1.x + n2.x) / factor * thickness,
+                       p1.y + (n1.y + n2.y) / factor * thickness };
+    }
+}
+
 void App::background(const sf::Color& color)
 {
-    window.clear(color);
+    m_renderer->clear(color);
 }
 
 void App::background(uint8_t shade)
 {
-    window.clear(sf::Color(shade, shade, shade));
+    m_renderer->clear(sf::Color(shade, shade, shade));
 }
 
 void App::background(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
 {
-    window.clear(sf::Color(r, g, b, a));
+    m_renderer->clear(sf::Color(r, g, b, a));
 }
 
 void App::fill(const sf::Color& color)
@@ -87,7 +171,14 @@ void App::strokeWeight(float weight)
 
 void App::push()
 {
+    if (m_drawStyleStack.full()) {
+        throw std::runtime_error(fmt::format(
+            "Cannot push any more style onto the stack: The maximum depth of {} is reached. "
+            "Did you forget to call pop()?",
+            m_drawStyleStack.capacity()));
+    }
     m_drawStyleStack.push_back(m_drawStyleStack.back());
+    m_frameStats.stylePushes++;
 }
 
 void App::pop()
@@ -97,28 +188,48 @@ void App::pop()
             "Cannot pop any more style from the stack: Nothing to pop");
     }
     m_drawStyleStack.pop_back();
+    m_frameStats.stylePops++;
 }
 
 void App::line(float x1, float y1, float x2, float y2)
 {
-    sf::RectangleShape line;
-    line.setFillColor(m_drawStyleStack.back().m_strokeColor);
-    line.setSize({ dist(x1, y1, x2, y2), m_drawStyleStack.back().m_strokeWeight });
-    line.setOrigin({ 0, m_drawStyleStack.back().m_strokeWeight / 2.0f });
-    line.setPosition({ x1, y1 });
-    line.setRotation(degrees(atan2f(y2 - y1, x2 - x1)));
-    window.draw(line);
+    drawLine(m_drawStyleStack.back(), x1, y1, x2, y2);
+}
+
+void App::lines(const float* x1, const float* y1, const float* x2, const float* y2, size_t count)
+{
+    const auto& style = m_drawStyleStack.back();
+    for (size_t i = 0; i < count; i++) {
+        drawLine(style, x1[i], y1[i], x2[i], y2[i]);
+    }
+}
+
+void App::lines(const glm::vec2* start, const glm::vec2* end, size_t count)
+{
+    const auto& style = m_drawStyleStack.back();
+    for (size_t i = 0; i < count; i++) {
+        drawLine(style, start[i].x, start[i].y, end[i].x, end[i].y);
+    }
+}
+
+void App::point(float x, float y)
+{
+    drawPoint(m_drawStyleStack.back(), x, y);
+}
+
+void App::points(const float* x, const float* y, size_t count)
+{
+    const auto& style = m_drawStyleStack.back();
+    for (size_t i = 0; i < count; i++) {
+        drawPoint(style, x[i], y[i]);
+    }
+}
 
-    if (m_drawStyleStack.back().m_lineCap == LineCap::Round) {
-        sf::CircleShape circle;
-        circle.setFillColor(m_drawStyleStack.back().m_strokeColor);
-        circle.setRadius(m_drawStyleStack.back().m_strokeWeight / 2.0f);
-        circle.setOrigin({ m_drawStyleStack.back().m_strokeWeight / 2.0f,
-                           m_drawStyleStack.back().m_strokeWeight / 2.0f });
-        circle.setPosition({ x1, y1 });
-        window.draw(circle);
-        circle.setPosition({ x2, y2 });
-        window.draw(circle);
+void App::points(const glm::vec2* positions, size_t count)
+{
+    const auto& style = m_drawStyleStack.back();
+    for (size_t i = 0; i < count; i++) {
+        drawPoint(style, positions[i].x, positions[i].y);
     }
 }
 
@@ -129,27 +240,23 @@ void App::lineCap(LineCap cap)
 
 void App::rect(float x, float y, float w, float h)
 {
-    if (m_drawStyleStack.back().m_rectMode == RectMode::Center) {
-        x -= w / 2.0f;
-        y -= h / 2.0f;
-    }
-    else if (m_drawStyleStack.back().m_rectMode == RectMode::Corner) {
-        // Do nothing
-    }
-    else if (m_drawStyleStack.back().m_rectMode == RectMode::Corners) {
-        w -= x;
-        h -= y;
+    drawRect(m_drawStyleStack.back(), x, y, w, h);
+}
+
+void App::rects(const float* x, const float* y, const float* w, const float* h, size_t count)
+{
+    const auto& style = m_drawStyleStack.back();
+    for (size_t i = 0; i < count; i++) {
+        drawRect(style, x[i], y[i], w[i], h[i]);
     }
-    else {
-        throw std::runtime_error("Unknown rect mode");
+}
+
+void App::rects(const glm::vec2* positions, const glm::vec2* sizes, size_t count)
+{
+    const auto& style = m_drawStyleStack.back();
+    for (size_t i = 0; i < count; i++) {
+        drawRect(style, positions[i].x, positions[i].y, sizes[i].x, sizes[i].y);
     }
-    sf::RectangleShape rect;
-    rect.setFillColor(m_drawStyleStack.back().m_fillColor);
-    rect.setOutlineColor(m_drawStyleStack.back().m_strokeColor);
-    rect.setOutlineThickness(m_drawStyleStack.back().m_strokeWeight);
-    rect.setPosition({ x, y });
-    rect.setSize({ w, h });
-    window.draw(rect);
 }
 
 void App::rectMode(RectMode mode)
@@ -159,39 +266,60 @@ void App::rectMode(RectMode mode)
 
 void App::circle(float x, float y, float radius)
 {
-    sf::CircleShape circle;
-    circle.setFillColor(m_drawStyleStack.back().m_fillColor);
-    circle.setOutlineColor(m_drawStyleStack.back().m_strokeColor);
-    circle.setOutlineThickness(m_drawStyleStack.back().m_strokeWeight);
-    circle.setRadius(radius);
-    circle.setOrigin({ radius, radius });
-    circle.setPosition({ x, y });
-    window.draw(circle);
+    drawCircle(m_drawStyleStack.back(), x, y, radius);
+}
+
+void App::circles(const float* x, const float* y, const float* radius, size_t count)
+{
+    const auto& style = m_drawStyleStack.back();
+    for (size_t i = 0; i < count; i++) {
+        drawCircle(style, x[i], y[i], radius[i]);
+    }
+}
+
+void App::circles(const glm::vec2* centers, const float* radius, size_t count)
+{
+    const auto& style = m_drawStyleStack.back();
+    for (size_t i = 0; i < count; i++) {
+        drawCircle(style, centers[i].x, centers[i].y, radius[i]);
+    }
 }
 
 void App::ellipse(float x, float y, float w, float h)
 {
-    sf::CircleShape circle;
-    circle.setFillColor(m_drawStyleStack.back().m_fillColor);
-    circle.setOutlineColor(m_drawStyleStack.back().m_strokeColor);
-    circle.setOutlineThickness(m_drawStyleStack.back().m_strokeWeight);
-    circle.setRadius(w / 2.0f);
-    circle.scale(1.0f,
-                 h / w); // sfml uses a circle as an ellipse, so we need to scale it
-    circle.setOrigin({ w / 2.0f, w / 2.0f });
-    circle.setPosition({ x, y });
-    window.draw(circle);
+    const auto& style = m_drawStyleStack.back();
+    float rx = w / 2.0f;
+    float ry = h / 2.0f;
+    const auto& unit = unitCircle(circleSegments(std::max(std::abs(rx), std::abs(ry))));
+    size_t count = unit.size();
+
+    countGrowth(m_shapePoints, count, m_frameStats);
+    m_shapePoints.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        m_shapePoints[i] = { x + unit[i].x * rx, y + unit[i].y * ry };
+    }
+    m_renderer->convex(m_shapePoints.data(), count, style.m_fillColor);
+
+    // The outline is offset along the normal of the ellipse, so that it keeps the same thickness everywhere
+    if (style.m_strokeWeight != 0) {
+        countGrowth(m_outlinePoints, count, m_frameStats);
+        m_outlinePoints.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            sf::Vector2f normal = { unit[i].x * ry, unit[i].y * rx };
+            float length = sqrtf(normal.x * normal.x + normal.y * normal.y);
+            if (length != 0.f) {
+                normal = { normal.x / length, normal.y / length };
+            }
+            m_outlinePoints[i] = m_shapePoints[i] + normal * style.m_strokeWeight;
+        }
+        m_renderer->ring(m_outlinePoints.data(), m_shapePoints.data(), count, style.m_strokeColor);
+    }
 }
 
 void App::triangle(float x1, float y1, float x2, float y2, float x3, float y3)
 {
-    sf::ConvexShape triangle;
-    triangle.setFillColor(m_drawStyleStack.back().m_fillColor);
-    triangle.setPointCount(3);
-    triangle.setPoint(0, { x1, y1 });
-    triangle.setPoint(1, { x2, y2 });
-    triangle.setPoint(2, { x3, y3 });
-    window.draw(triangle);
+    sf::Vector2f points[3] = { { x1, y1 }, { x2, y2 }, { x3, y3 } };
+    m_renderer->convex(points, 3, m_drawStyleStack.back().m_fillColor);
 
     line(x1, y1, x2, y2);
     line(x2, y2, x3, y3);
@@ -221,11 +349,53 @@ void App::vector(float vectorX, float vectorY, float originX, float originY)
     pop();
 }
 
-void App::textFont(const sf::Font& font)
+void App::textFont(Font font)
 {
     m_drawStyleStack.back().m_font = font;
 }
 
+// Only metrics that FreeType knows without rendering glyphs, so that no texture is created
+static std::array<float, 4> fontMetrics(const sf::Font& font)
+{
+    constexpr unsigned int SIZE = 64;
+    return { font.getLineSpacing(SIZE),
+             font.getUnderlinePosition(SIZE),
+             font.getUnderlineThickness(SIZE),
+             font.getKerning('A', 'V', SIZE) };
+}
+
+void App::textFont(const sf::Font& font)
+{
+    std::string family = font.getInfo().family;
+    std::array<float, 4> metrics = fontMetrics(font);
+
+    for (auto& userFont : m_userFonts) {
+        if (userFont.source != &font) {
+            continue;
+        }
+        if (userFont.family != family || userFont.metrics != metrics) {
+            // Another font lives at this address now, it takes over the id. Nothing cached for the old font
+            // may be used for it, and pending text still refers to the pages of the old copy.
+            if (m_renderer) {
+                m_renderer->flush();
+                m_renderer->forgetFont(userFont.id);
+            }
+            *userFont.copy = font;
+            userFont.family = std::move(family);
+            userFont.metrics = metrics;
+        }
+        m_drawStyleStack.back().m_font = Font(userFont.id);
+        return;
+    }
+
+    auto id = static_cast<uint32_t>(m_fonts.size());
+    auto copy = std::make_unique<sf::Font>(font);
+    m_fonts.push_back(copy.get());
+    m_fontFiles.emplace_back();
+    m_userFonts.push_back({ &font, std::move(family), metrics, std::move(copy), id });
+    m_drawStyleStack.back().m_font = Font(id);
+}
+
 sf::Font App::loadFont(const std::string& filename)
 {
     sf::Font font;
@@ -235,6 +405,21 @@ sf::Font App::loadFont(const std::string& filename)
     return font;
 }
 
+Font App::openFont(const std::string& filename)
+{
+    // SFML reads fonts from memory lazily, so the file stays in memory as long as the font
+    auto font = std::make_unique<LoadedFont>();
+    std::ifstream file(filename, std::ios::binary);
+    font->file.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (!file || !font->font.loadFromMemory(font->file.data(), font->file.size())) {
+        throw std::runtime_error("[cppgfx] Failed to load font: " + filename);
+    }
+    m_fonts.push_back(&font->font);
+    m_fontFiles.push_back({ font->file.data(), font->file.size() });
+    m_loadedFonts.push_back(std::move(font));
+    return Font(static_cast<uint32_t>(m_fonts.size() - 1));
+}
+
 void App::textAlign(TextAlign align)
 {
     m_drawStyleStack.back().m_textAlign = align;
@@ -242,11 +427,14 @@ void App::textAlign(TextAlign align)
 
 float App::textWidth(const std::string& text)
 {
-    sf::Text sfText;
-    sfText.setFont(m_drawStyleStack.back().m_font);
-    sfText.setString(text);
-    sfText.setCharacterSize(m_drawStyleStack.back().m_fontSize);
-    return sfText.getLocalBounds().width;
+    float width = 0.f;
+    m_renderer->textWidths(&text, 1, textStyle(m_drawStyleStack.back()), &width);
+    return width;
+}
+
+void App::textWidths(const std::string* texts, size_t count, float* widths)
+{
+    m_renderer->textWidths(texts, count, textStyle(m_drawStyleStack.back()), widths);
 }
 
 void App::textSize(uint32_t size)
@@ -256,27 +444,107 @@ void App::textSize(uint32_t size)
 
 void App::text(const std::string& text, float x, float y)
 {
-    sf::Text sfText;
-    sfText.setFont(m_drawStyleStack.back().m_font);
-    sfText.setString(text);
-    sfText.setCharacterSize(m_drawStyleStack.back().m_fontSize);
-    sfText.setFillColor(m_drawStyleStack.back().m_fillColor);
-    sfText.setOutlineColor(m_drawStyleStack.back().m_strokeColor);
-    sfText.setOutlineThickness(m_drawStyleStack.back().m_strokeWeight);
-    sfText.setOrigin({ 0, sfText.getLocalBounds().top });
-    if (m_drawStyleStack.back().m_textAlign == TextAlign::Left) {
-        sfText.setPosition({ x, y });
+    m_frameStats.textDraws++;
+    const auto& style = m_drawStyleStack.back();
+
+    float align = 0.f;
+    if (style.m_textAlign == TextAlign::Left) {
+        align = 0.f;
     }
-    else if (m_drawStyleStack.back().m_textAlign == TextAlign::Center) {
-        sfText.setPosition({ x - sfText.getLocalBounds().width / 2.0f, y });
+    else if (style.m_textAlign == TextAlign::Center) {
+        align = 0.5f;
     }
-    else if (m_drawStyleStack.back().m_textAlign == TextAlign::Right) {
-        sfText.setPosition({ x - sfText.getLocalBounds().width, y });
+    else if (style.m_textAlign == TextAlign::Right) {
+        align = 1.f;
     }
     else {
         throw std::runtime_error("Unknown text align");
     }
-    window.draw(sfText);
+
+    m_renderer->text(text, { x, y }, align, textStyle(style));
+}
+
+void App::flush()
+{
+    m_renderer->flush();
+}
+
+void App::setRenderer(std::unique_ptr<Renderer> renderer)
+{
+    if (m_renderer) {
+        m_renderer->flush();
+    }
+    m_renderer = renderer ? std::move(renderer) : std::make_unique<SfmlRenderer>(getWindow());
+    m_renderer->setStats(&m_frameStats);
+}
+
+Renderer& App::getRenderer()
+{
+    if (!m_renderer) {
+        setRenderer(nullptr);
+    }
+    return *m_renderer;
+}
+
+sf::RenderWindow& App::getWindow()
+{
+    // Even a closed window needs a display on some platforms, so it is only created when needed
+    return m_window.create();
+}
+
+const FrameProfiler& App::getProfiler() const
+{
+    return m_profiler;
+}
+
+void App::saveTrace(const std::string& path)
+{
+#ifdef CPPGFX_PROFILER
+    std::ofstream file(path);
+    if (!file) {
+        throw std::runtime_error("[cppgfx]: Failed to open trace file: " + path);
+    }
+    profilerWriteTrace(file);
+    if (!file) {
+        throw std::runtime_error("[cppgfx]: Failed to write trace file: " + path);
+    }
+#else
+    throw std::runtime_error("[cppgfx]: Cannot save trace to '" + path + "', cppgfx was built without USE_PROFILER");
+#endif
+}
+
+// =======================================
+// =====         Input API        ========
+// =======================================
+
+// Codes like sf::Keyboard::Unknown or sf::Mouse::ButtonCount are outside of the bitsets, which would throw
+template<size_t N>
+static bool inBitset(const std::bitset<N>& bits, int index)
+{
+    return index >= 0 && static_cast<size_t>(index) < bits.size();
+}
+
+template<size_t N>
+static void setBit(std::bitset<N>& bits, int index, bool value)
+{
+    if (inBitset(bits, index)) {
+        bits.set(static_cast<size_t>(index), value);
+    }
+}
+
+bool App::isKeyDown(sf::Keyboard::Key key) const
+{
+    return inBitset(m_keys, key) && m_keys.test(static_cast<size_t>(key));
+}
+
+bool App::isMouseButtonDown(sf::Mouse::Button button) const
+{
+    return inBitset(m_mouseButtons, button) && m_mouseButtons.test(static_cast<size_t>(button));
+}
+
+const std::vector<InputEvent>& App::inputEvents() const
+{
+    return m_inputEvents;
 }
 
 // =======================================
@@ -287,41 +555,92 @@ void App::size(int w, int h)
 {
     this->width = w;
     this->height = h;
-    window.setSize(sf::Vector2u(w, h));
+    if (m_window) {
+        m_window->setSize(sf::Vector2u(w, h));
+    }
 }
 
 void App::setTitle(const std::string& text)
 {
     this->title = text;
-    window.setTitle(text);
+    if (m_window) {
+        m_window->setTitle(text);
+    }
 }
 
 void App::setFrameRate(float framerate)
 {
-    window.setFramerateLimit(static_cast<unsigned int>(framerate));
+    m_frameRateLimit = framerate;
+    applyFrameRateLimit();
+}
+
+void App::setVerticalSync(bool enabled)
+{
+    m_verticalSync = enabled;
+    if (m_window) {
+        m_window->setVerticalSyncEnabled(enabled);
+    }
+    m_pacer.setVerticalSync(enabled);
+}
+
+PacingStats App::getPacingStats() const
+{
+    return m_pacer.stats();
+}
+
+void App::noLoop()
+{
+    m_looping = false;
+}
+
+void App::loop()
+{
+    m_looping = true;
+}
+
+void App::redraw()
+{
+    m_pendingRedraws = std::max(m_pendingRedraws, 1u);
+}
+
+bool App::isLooping() const
+{
+    return m_looping;
 }
 
 void App::fullscreen()
 {
+    if (!m_window) {
+        return;
+    }
     m_widthBeforeFullscreen = width;
     m_heightBeforeFullscreen = height;
-    window.create(sf::VideoMode::getDesktopMode(), title, sf::Style::Fullscreen);
+    m_window->create(sf::VideoMode::getDesktopMode(), title, sf::Style::Fullscreen);
+    m_window->setVerticalSyncEnabled(m_verticalSync);
 }
 
 void App::exitFullscreen()
 {
-    window.create(sf::VideoMode({ m_widthBeforeFullscreen, m_heightBeforeFullscreen }),
-                  title);
+    if (!m_window) {
+        return;
+    }
+    m_window->create(sf::VideoMode({ m_widthBeforeFullscreen, m_heightBeforeFullscreen }), title);
+    m_window->setVerticalSyncEnabled(m_verticalSync);
 }
 
 void App::close()
 {
-    window.close();
+    m_windowShouldClose = true;
+    if (m_window) {
+        m_window->close();
+    }
 }
 
 void App::focus()
 {
-    window.requestFocus();
+    if (m_window) {
+        m_window->requestFocus();
+    }
 }
 
 // =======================================
@@ -333,6 +652,11 @@ float App::dist(float x1, float y1, float x2, float y2)
     return sqrtf(powf(x2 - x1, 2) + powf(y2 - y1, 2));
 }
 
+float App::lerp(float start, float stop, float amount)
+{
+    return start + (stop - start) * amount;
+}
+
 float App::radians(float degrees)
 {
     return degrees * (PI / 180.0f);
@@ -345,12 +669,15 @@ float App::degrees(float radians)
 
 void App::randomSeed(uint32_t seed)
 {
-    std::srand(seed);
+    m_random.seed(seed);
 }
 
 int App::randomInt(int min, int max)
 {
-    return min + std::rand() / (RAND_MAX / (max - min));
+    if (max < min) {
+        std::swap(min, max);
+    }
+    return std::uniform_int_distribution<int>(min, max)(m_random);
 }
 
 int App::randomInt(int max)
@@ -360,8 +687,10 @@ int App::randomInt(int max)
 
 float App::random(float min, float max)
 {
-    return min
-        + static_cast<float>(std::rand()) / (static_cast<float>(RAND_MAX / (max - min)));
+    if (max < min) {
+        std::swap(min, max);
+    }
+    return std::uniform_real_distribution<float>(min, max)(m_random);
 }
 
 float App::random(float max)
@@ -375,11 +704,17 @@ float App::random(float max)
 
 uint64_t App::micros()
 {
+    if (m_headless) {
+        return m_simulatedMicros;
+    }
     return static_cast<uint64_t>(m_lifetimeClock.getElapsedTime().asMicroseconds());
 }
 
 uint64_t App::millis()
 {
+    if (m_headless) {
+        return m_simulatedMicros / 1000;
+    }
     return static_cast<uint64_t>(m_lifetimeClock.getElapsedTime().asMilliseconds());
 }
 
@@ -431,6 +766,25 @@ int App::year()
     return now_tm->tm_year + 1900;
 }
 
+// =======================================
+// =====       Threading API      ========
+// =======================================
+
+void App::waitAll()
+{
+    if (m_jobs) {
+        m_jobs->wait(m_jobGroup);
+    }
+}
+
+JobSystem& App::jobs()
+{
+    if (!m_jobs) {
+        m_jobs = (workerThreads > 0) ? std::make_shared<JobSystem>(workerThreads) : JobSystem::shared();
+    }
+    return *m_jobs;
+}
+
 // =======================================
 // =====        Reserved API      ========
 // =======================================
@@ -520,455 +874,632 @@ static void LoadDefaultImGuiStyle()
     style.GrabRounding = 10.0f;
 }
 
-sf::Font App::loadFont(const std::string& filename)
+void App::run()
 {
-    sf::Font font;
-    if (!font.loadFromFile(filename)) {
-        throw std::runtime_error("[cppgfx] Failed to load font: " + filename);
-    }
-    return font;
-}
+    m_instance = this;
 
-void App::textAlign(TextAlign align)
-{
-    m_drawStyleStack.back().m_textAlign = align;
-}
+    sf::ContextSettings settings;
+    settings.antialiasingLevel = 8.0;
 
-float App::textWidth(const std::string& text)
-{
-    sf::Text sfText;
-    sfText.setFont(m_drawStyleStack.back().m_font);
-    sfText.setString(text);
-    sfText.setCharacterSize(m_drawStyleStack.back().m_fontSize);
-    return sfText.getLocalBounds().width;
-}
+    // The window exists from now on, so that setup() can already use it
+    sf::RenderWindow& window = getWindow();
+    if (!m_renderer) {
+        setRenderer(nullptr);
+    }
 
-void App::textSize(uint32_t size)
-{
-    m_drawStyleStack.back().m_fontSize = size;
-}
+    updateDisplaySize();
+    setup();
 
-void App::text(const std::string& text, float x, float y)
-{
-    sf::Text sfText;
-    sfText.setFont(m_drawStyleStack.back().m_font);
-    sfText.setString(text);
-    sfText.setCharacterSize(m_drawStyleStack.back().m_fontSize);
-    sfText.setFillColor(m_drawStyleStack.back().m_fillColor);
-    sfText.setOutlineColor(m_drawStyleStack.back().m_strokeColor);
-    sfText.setOutlineThickness(m_drawStyleStack.back().m_strokeWeight);
-    sfText.setOrigin({ 0, sfText.getLocalBounds().top });
-    if (m_drawStyleStack.back().m_textAlign == TextAlign::Left) {
-        sfText.setPosition({ x, y });
-    }
-    else if (m_drawStyleStack.back().m_textAlign == TextAlign::Center) {
-        sfText.setPosition({ x - sfText.getLocalBounds().width / 2.0f, y });
-    }
-    else if (m_drawStyleStack.back().m_textAlign == TextAlign::Right) {
-        sfText.setPosition({ x - sfText.getLocalBounds().width, y });
+    window.create(sf::VideoMode({ width, height }), title, sf::Style::Default, settings);
+    window.setVerticalSyncEnabled(m_verticalSync);
+    applyFrameRateLimit();
+    auto pngData = decodeBase64(CPP_LOGO_BASE64);
+    sf::Image icon;
+    if (icon.loadFromMemory(pngData.data(), pngData.size())) {
+        window.setIcon(icon.getSize().x, icon.getSize().y, icon.getPixelsPtr());
     }
-    else {
-        throw std::runtime_error("Unknown text align");
+
+    if (!ImGui::SFML::Init(window)) {
+        throw std::runtime_error("[cppgfx]: Failed to initialize ImGui");
     }
-    window.draw(sfText);
-}
+    LoadDefaultImGuiStyle();
 
-// =======================================
-// =====         Window API       ========
-// =======================================
+    ImFontConfig font_cfg;
+    font_cfg.FontDataOwnedByAtlas = false;
+    ImGui::GetIO().Fonts->AddFontFromMemoryTTF(
+        (void*)ROBOTO_MEDIUM_DATA, ROBOTO_MEDIUM_SIZE, 18.0f, &font_cfg);
 
-void App::size(int w, int h)
-{
-    this->width = w;
-    this->height = h;
-    window.setSize(sf::Vector2u(w, h));
-}
+    if (!ImGui::SFML::UpdateFontTexture()) {
+        throw std::runtime_error("[cppgfx]: Failed to update ImGui font texture");
+    }
+    ImGui::GetIO().FontDefault = ImGui::GetIO().Fonts->Fonts.back();
 
-void App::setTitle(const std::string& text)
-{
-    this->title = text;
-    window.setTitle(text);
-}
+    // Afterwards, the mouse position is only taken from events
+    m_mousePosition = sf::Mouse::getPosition(window);
+    mouseX = m_mousePosition.x;
+    mouseY = m_mousePosition.y;
 
-void App::setFrameRate(float framerate)
-{
-    window.setFramerateLimit(static_cast<unsigned int>(framerate));
-}
+    // The first frame is always drawn, even if noLoop() was called in setup()
+    m_pendingRedraws = 1;
 
-void App::fullscreen()
-{
-    m_widthBeforeFullscreen = width;
-    m_heightBeforeFullscreen = height;
-    window.create(sf::VideoMode::getDesktopMode(), title, sf::Style::Fullscreen);
-}
+    while (window.isOpen() && !m_windowShouldClose) {
 
-void App::exitFullscreen()
-{
-    window.create(sf::VideoMode({ m_widthBeforeFullscreen, m_heightBeforeFullscreen }),
-                  title);
+        // Sleep until something needs to be drawn
+        if (isIdle()) {
+            waitWhileIdle();
+            if (!window.isOpen() || m_windowShouldClose) {
+                break;
+            }
+        }
+
+        // Handle dark title bar
+        if (darkTitleBar != m_isDarkTitleBar) {
+#ifdef _WIN32
+            Win32EnableDarkTitleBar(window.getSystemHandle(), darkTitleBar);
+#endif
+            m_isDarkTitleBar = darkTitleBar;
+        }
+
+        // Prepare data
+        m_profiler.beginFrame();
+        updateDisplaySize();
+        focused = window.hasFocus();
+        frameTime = (m_frametimeClock.restart() - m_idleTime).asSeconds();
+        m_idleTime = sf::Time::Zero;
+        if (m_resumed) {
+            // Do not count the time in the background, as if the application was never gone
+            frameTime = std::min(frameTime, 1.0f / (m_frameRateLimit > 0 ? m_frameRateLimit : 60.0f));
+            m_resumed = false;
+        }
+        frameRate = 1.0f / frameTime;
+
+        // Handle events
+        sf::Event event {};
+        while (window.pollEvent(event)) {
+            handleEvent(event);
+        }
+        if (m_pendingMouseMove) {
+            m_pendingMouseMove = false;
+            onMouseMoved({ m_mousePosition.x, m_mousePosition.y });
+        }
+        m_profiler.endPhase(FramePhase::Events);
+
+        // Call the user's update function
+        ImGui::SFML::Update(window, m_frametimeClock.restart());
+        m_renderer->clear(m_defaultBackgroundColor);
+        stroke(0, 0, 0);
+        strokeWeight(2);
+        fill(255, 255, 255);
+        latchInput();
+        runSimulation(frameTime);
+        update();
+        waitAll();
+        m_profiler.endPhase(FramePhase::Update);
+
+        if (m_inBackground && backgroundMode == BackgroundMode::PauseRendering) {
+            m_renderer->discard();
+            m_profiler.endPhase(FramePhase::Flush);
+            ImGui::EndFrame();
+            m_profiler.endPhase(FramePhase::ImGui);
+        }
+        else {
+            m_renderer->flush();
+            m_profiler.endPhase(FramePhase::Flush);
+            if (showProfiler) {
+                m_profiler.drawOverlay(frameStats);
+            }
+            ImGui::SFML::Render(window);
+            m_profiler.endPhase(FramePhase::ImGui);
+
+            // Display the window
+            window.display();
+        }
+
+        // Wait for the deadline of the frame, which is the framerate limit
+        m_pacer.wait();
+        m_profiler.endPhase(FramePhase::Display);
+
+        // Post update
+        frameCount++;
+        if (m_pendingRedraws > 0) {
+            m_pendingRedraws--;
+        }
+        frameStats = m_frameStats;
+        m_frameStats = FrameStats();
+        m_inputEvents.clear();
+        m_profiler.endFrame();
+    }
+
+    // Call the user defined cleanup
+    cleanup();
+
+    ImGui::SFML::Shutdown();
 }
 
-void App::close()
+void App::runHeadless(uint64_t frames, float fixedDt, const std::function<void(const SoftwareRenderer&)>& onFrame)
 {
-    m_windowShouldClose = true;
-    window.close();
+    if (!(fixedDt > 0)) {
+        throw std::runtime_error("[cppgfx]: The frame time of a headless run must be positive");
+    }
+
+    m_instance = this;
+
+    // There is no monitor to ask, so the display is as large as the image
+    m_headless = true;
+    m_simulatedMicros = 0;
+    displayWidth = width;
+    displayHeight = height;
+
+    // Also before setup(), so that measuring text never needs the window. The size is updated every frame.
+    auto renderer = dynamic_cast<SoftwareRenderer*>(m_renderer.get());
+    if (!renderer) {
+        auto softwareRenderer = std::make_unique<SoftwareRenderer>(width, height);
+        renderer = softwareRenderer.get();
+        setRenderer(std::move(softwareRenderer));
+    }
+
+    setup();
+
+    // ImGui runs without a backend, its output is discarded
+    ImGui::CreateContext();
+    LoadDefaultImGuiStyle();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    ImFontConfig font_cfg;
+    font_cfg.FontDataOwnedByAtlas = false;
+    io.FontDefault = io.Fonts->AddFontFromMemoryTTF(
+        (void*)ROBOTO_MEDIUM_DATA, ROBOTO_MEDIUM_SIZE, 18.0f, &font_cfg);
+    unsigned char* fontPixels = nullptr;
+    int fontWidth = 0;
+    int fontHeight = 0;
+    io.Fonts->GetTexDataAsAlpha8(&fontPixels, &fontWidth, &fontHeight);
+
+    uint64_t frameMicros = static_cast<uint64_t>(std::llround(static_cast<double>(fixedDt) * 1e6));
+    for (uint64_t frame = 0; frame < frames && !m_windowShouldClose; frame++) {
+
+        // Prepare data
+        m_profiler.beginFrame();
+        if (renderer->getWidth() != width || renderer->getHeight() != height) {
+            renderer->resize(width, height);
+        }
+        frameTime = fixedDt;
+        frameRate = 1.0f / fixedDt;
+        io.DisplaySize = ImVec2(static_cast<float>(width), static_cast<float>(height));
+        io.DeltaTime = fixedDt;
+        m_profiler.endPhase(FramePhase::Events);
+
+        // Call the user's update function
+        ImGui::NewFrame();
+        m_renderer->clear(m_defaultBackgroundColor);
+        stroke(0, 0, 0);
+        strokeWeight(2);
+        fill(255, 255, 255);
+        runSimulation(fixedDt);
+        update();
+        waitAll();
+        m_profiler.endPhase(FramePhase::Update);
+        m_renderer->flush();
+        m_profiler.endPhase(FramePhase::Flush);
+        ImGui::EndFrame();
+        m_profiler.endPhase(FramePhase::ImGui);
+
+        // The frame is handed to the caller instead of being displayed
+        onFrame(*renderer);
+        m_profiler.endPhase(FramePhase::Display);
+
+        // Post update
+        frameCount++;
+        frameStats = m_frameStats;
+        m_frameStats = FrameStats();
+        m_profiler.endFrame();
+        m_simulatedMicros += frameMicros;
+    }
+
+    // Call the user defined cleanup
+    cleanup();
+
+    ImGui::DestroyContext();
+    m_headless = false;
 }
 
-void App::focus()
+void App::runHeadless(uint64_t frames, float fixedDt, const std::string& path)
 {
-    window.requestFocus();
+    runHeadless(frames, fixedDt, [this, &path](const SoftwareRenderer& renderer) {
+        std::string filename = fmt::format(fmt::runtime(path), frameCount);
+        if (!renderer.toImage().saveToFile(filename)) {
+            throw std::runtime_error("[cppgfx]: Failed to save frame: " + filename);
+        }
+    });
 }
 
 // =======================================
-// =====         Math API         ========
+// =====           Private        ========
 // =======================================
 
-float App::dist(float x1, float y1, float x2, float y2)
+void App::updateDisplaySize()
 {
-    return sqrtf(powf(x2 - x1, 2) + powf(y2 - y1, 2));
+    displayWidth = sf::VideoMode::getDesktopMode().width;
+    displayHeight = sf::VideoMode::getDesktopMode().height;
 }
 
-float App::radians(float degrees)
-{
-    return degrees * (PI / 180.0f);
+static bool isInputEvent(sf::Event::EventType type)
+{
+    switch (type) {
+    case sf::Event::TextEntered:
+    case sf::Event::KeyPressed:
+    case sf::Event::KeyReleased:
+    case sf::Event::MouseButtonPressed:
+    case sf::Event::MouseButtonReleased:
+    case sf::Event::MouseMoved:
+    case sf::Event::MouseWheelScrolled:
+    case sf::Event::MouseEntered:
+    case sf::Event::MouseLeft:
+        return true;
+    default:
+        return false;
+    }
 }
 
-float App::degrees(float radians)
+void App::handleEvent(const sf::Event& event)
 {
-    return radians * (180.0f / PI);
-}
+    ImGui::SFML::ProcessEvent(*m_window, event);
 
-void App::randomSeed(uint32_t seed)
-{
-    std::srand(seed);
-}
+    // ImGui reacts to input one frame late, so input renders two frames while not looping
+    constexpr uint32_t INPUT_REDRAW_FRAMES = 2;
+    if (redrawOnInput && isInputEvent(event.type)) {
+        m_pendingRedraws = std::max(m_pendingRedraws, INPUT_REDRAW_FRAMES);
+    }
 
-int App::randomInt(int min, int max)
-{
-    return min + std::rand() / (RAND_MAX / (max - min));
-}
+    // Without frames, e.g. with noLoop() and redrawOnInput disabled, only the most recent events are kept
+    constexpr size_t MAX_INPUT_EVENTS = 8192;
+    if (isInputEvent(event.type)) {
+        if (m_inputEvents.size() >= MAX_INPUT_EVENTS) {
+            m_inputEvents.erase(m_inputEvents.begin(), m_inputEvents.begin() + MAX_INPUT_EVENTS / 4);
+        }
+        m_inputEvents.push_back({ event, micros() });
+    }
 
-int App::randomInt(int max)
-{
-    return random(0, max);
-}
+    switch (event.type) {
+
+    case sf::Event::TextEntered:
+        onTextInput(event.text);
+        break;
+
+    case sf::Event::KeyPressed:
+        setBit(m_keys, event.key.code, true);
+        onKeyPressed(event.key);
+        break;
+
+    case sf::Event::KeyReleased:
+        setBit(m_keys, event.key.code, false);
+        onKeyReleased(event.key);
+        break;
+
+    case sf::Event::MouseButtonPressed:
+        m_mousePosition = { event.mouseButton.x, event.mouseButton.y };
+        setBit(m_mouseButtons, event.mouseButton.button, true);
+        onMousePressed(event.mouseButton);
+        break;
+
+    case sf::Event::MouseButtonReleased:
+        m_mousePosition = { event.mouseButton.x, event.mouseButton.y };
+        setBit(m_mouseButtons, event.mouseButton.button, false);
+        onMouseReleased(event.mouseButton);
+        break;
+
+    case sf::Event::MouseMoved:
+        m_mousePosition = { event.mouseMove.x, event.mouseMove.y };
+        if (coalesceMouseMoves) {
+            m_pendingMouseMove = true;
+        }
+        else {
+            onMouseMoved(event.mouseMove);
+        }
+        break;
 
-float App::random(float min, float max)
-{
-    return min
-        + static_cast<float>(std::rand()) / (static_cast<float>(RAND_MAX / (max - min)));
-}
+    case sf::Event::MouseWheelScrolled:
+        onMouseWheel(event.mouseWheelScroll);
+        break;
 
-float App::random(float max)
-{
-    return random(0.0f, max);
-}
+    case sf::Event::MouseEntered:
+        onMouseEnter();
+        break;
 
-// =======================================
-// =====     Time and Date API    ========
-// =======================================
+    case sf::Event::MouseLeft:
+        onMouseLeave();
+        break;
 
-uint64_t App::micros()
-{
-    return static_cast<uint64_t>(m_lifetimeClock.getElapsedTime().asMicroseconds());
+    case sf::Event::Closed:
+        if (onWindowClose()) {
+            m_window->close();
+        }
+        break;
+
+    case sf::Event::Resized:
+        width = event.size.width;
+        height = event.size.height;
+        onWindowResize();
+        redraw();
+        break;
+
+    case sf::Event::GainedFocus:
+        onWindowFocus();
+        redraw();
+        break;
+
+    case sf::Event::LostFocus:
+        // Releases happen in another window then, so they would never arrive
+        m_keys.reset();
+        m_mouseButtons.reset();
+        onWindowUnfocus();
+        redraw();
+        break;
+
+    default:
+        break;
+    }
 }
 
-uint64_t App::millis()
+bool App::isIdle()
 {
-    return static_cast<uint64_t>(m_lifetimeClock.getElapsedTime().asMilliseconds());
+    updateBackgroundState();
+    bool suspended = m_inBackground && backgroundMode == BackgroundMode::Suspend;
+    return suspended || (!m_looping && m_pendingRedraws == 0);
 }
 
-int App::second()
+void App::waitWhileIdle()
 {
-    auto now = std::chrono::system_clock::now();
-    auto now_c = std::chrono::system_clock::to_time_t(now);
-    auto now_tm = std::localtime(&now_c);
-    return now_tm->tm_sec;
+    // Block in the event queue instead of spinning, the time spent here does not count towards frameTime
+    sf::Event event {};
+    while (isIdle() && m_window->isOpen() && !m_windowShouldClose) {
+        sf::Clock idleClock;
+        bool received = m_window->waitEvent(event);
+        m_idleTime += idleClock.getElapsedTime();
+        if (!received) {
+            break;
+        }
+        handleEvent(event);
+    }
+
+    // The schedule continues from now on, instead of catching up on the frames that were never rendered
+    m_pacer.reset();
 }
 
-int App::minute()
+void App::latchInput()
 {
-    auto now = std::chrono::system_clock::now();
-    auto now_c = std::chrono::system_clock::to_time_t(now);
-    auto now_tm = std::localtime(&now_c);
-    return now_tm->tm_min;
+    pmouseX = mouseX;
+    pmouseY = mouseY;
+    mouseX = m_mousePosition.x;
+    mouseY = m_mousePosition.y;
+    dmouseX = mouseX - pmouseX;
+    dmouseY = mouseY - pmouseY;
+    mousePressed = m_mouseButtons.any();
 }
 
-int App::hour()
+void App::runSimulation(float elapsed)
 {
-    auto now = std::chrono::system_clock::now();
-    auto now_c = std::chrono::system_clock::to_time_t(now);
-    auto now_tm = std::localtime(&now_c);
-    return now_tm->tm_hour;
+    simulationSteps = 0;
+    if (!(simulationRate > 0)) {
+        m_simulationTime = 0;
+        interpolationAlpha = 1;
+        return;
+    }
+
+    // The remaining time is carried over to the next frame, so no time is lost between the steps
+    double step = 1.0 / simulationRate;
+    m_simulationTime += elapsed;
+    while (m_simulationTime >= step && simulationSteps < maxSimulationSteps) {
+        CPPGFX_PROFILE_SCOPE("simulate");
+        simulate(static_cast<float>(step));
+        m_simulationTime -= step;
+        simulationSteps++;
+    }
+    if (m_simulationTime >= step) {
+        m_simulationTime = std::fmod(m_simulationTime, step);
+    }
+    interpolationAlpha = static_cast<float>(m_simulationTime / step);
 }
 
-int App::day()
+bool App::isMinimized()
 {
-    auto now = std::chrono::system_clock::now();
-    auto now_c = std::chrono::system_clock::to_time_t(now);
-    auto now_tm = std::localtime(&now_c);
-    return now_tm->tm_mday;
+#ifdef _WIN32
+    return Win32IsMinimized(m_window->getSystemHandle());
+#else
+    return false;
+#endif
 }
 
-int App::month()
+void App::updateBackgroundState()
 {
-    auto now = std::chrono::system_clock::now();
-    auto now_c = std::chrono::system_clock::to_time_t(now);
-    auto now_tm = std::localtime(&now_c);
-    return now_tm->tm_mon + 1;
+    bool background = backgroundMode != BackgroundMode::Continue && (!m_window->hasFocus() || isMinimized());
+    if (background == m_inBackground) {
+        return;
+    }
+
+    m_inBackground = background;
+    m_resumed = !background;
+    applyFrameRateLimit();
 }
 
-int App::year()
+void App::applyFrameRateLimit()
 {
-    auto now = std::chrono::system_clock::now();
-    auto now_c = std::chrono::system_clock::to_time_t(now);
-    auto now_tm = std::localtime(&now_c);
-    return now_tm->tm_year + 1900;
+    // The window does not limit the framerate itself, since it only sleeps with millisecond precision
+    float limit = m_inBackground ? backgroundFrameRate : m_frameRateLimit;
+    if (m_window) {
+        m_window->setFramerateLimit(0);
+    }
+    m_pacer.setRate(limit);
 }
 
-// =======================================
-// =====        Reserved API      ========
-// =======================================
-
-template <typename T> static inline T Lerp(T a, T b, float t)
+const sf::Font& App::getFont(Font font) const
 {
-    return (T)(a + (b - a) * t);
+    return *m_fonts.at(font.m_id);
 }
-static inline ImVec2 Lerp(const ImVec2& a, const ImVec2& b, float t)
+
+TextStyle App::textStyle(const DrawStyle& style) const
 {
-    return { a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t };
+    TextStyle textStyle;
+    textStyle.font = &getFont(style.m_font);
+    textStyle.fontId = style.m_font.m_id;
+    textStyle.characterSize = style.m_fontSize;
+    textStyle.outlineThickness = style.m_strokeWeight;
+    textStyle.fillColor = style.m_fillColor;
+    textStyle.outlineColor = style.m_strokeColor;
+    textStyle.fontData = m_fontFiles[style.m_font.m_id].data;
+    textStyle.fontDataSize = m_fontFiles[style.m_font.m_id].size;
+    return textStyle;
 }
-static inline ImVec2 Lerp(const ImVec2& a, const ImVec2& b, const ImVec2& t)
-{
-    return { a.x + (b.x - a.x) * t.x, a.y + (b.y - a.y) * t.y };
-}
-static inline ImVec4 Lerp(const ImVec4& a, const ImVec4& b, float t)
+
+void App::updateLineCapCache(float weight, LineCap cap)
 {
-    return { a.x + (b.x - a.x) * t,
-             a.y + (b.y - a.y) * t,
-             a.z + (b.z - a.z) * t,
-             a.w + (b.w - a.w) * t };
+    // Offsets of one cap along and across the line direction, from one long side to the other.
+    // A square cap is a single segment, which results in a plain rectangle.
+    float radius = weight / 2.0f;
+    size_t segments = (cap == LineCap::Round) ? std::max<size_t>(arcSegments(radius, PI), 2) : 1;
+    countGrowth(m_lineCapCache.offsets, segments + 1, m_frameStats);
+    m_lineCapCache.offsets.resize(segments + 1);
+    for (size_t i = 0; i <= segments; i++) {
+        float angle = static_cast<float>(i) * PI / static_cast<float>(segments);
+        m_lineCapCache.offsets[i] = { sinf(angle) * radius, cosf(angle) * radius };
+    }
+    if (cap == LineCap::Square) {
+        m_lineCapCache.offsets.front().x = 0.f;
+        m_lineCapCache.offsets.back().x = 0.f;
+    }
+    m_lineCapCache.weight = weight;
+    m_lineCapCache.cap = cap;
 }
 
-static void LoadDefaultImGuiStyle()
+void App::drawLine(const DrawStyle& style, float x1, float y1, float x2, float y2)
 {
-    auto colors = ImGui::GetStyle().Colors;
-
-    colors[ImGuiCol_Text] = ImVec4(1.00f, 1.00f, 1.00f, 1.00f);
-    colors[ImGuiCol_TextDisabled] = ImVec4(0.50f, 0.50f, 0.50f, 1.00f);
-    colors[ImGuiCol_WindowBg] = ImVec4(0.10f, 0.10f, 0.10f, 0.8f);
-    colors[ImGuiCol_ChildBg] = ImVec4(0.00f, 0.00f, 0.00f, 0.00f);
-    colors[ImGuiCol_PopupBg] = ImVec4(0.08f, 0.08f, 0.08f, 0.94f);
-    colors[ImGuiCol_Border] = ImVec4(0.43f, 0.43f, 0.50f, 0.50f);
-    colors[ImGuiCol_BorderShadow] = ImVec4(0.00f, 0.00f, 0.00f, 0.00f);
-    colors[ImGuiCol_FrameBg] = ImVec4(0.53f, 0.53f, 0.53f, 0.48f);
-    colors[ImGuiCol_FrameBgHovered] = ImVec4(0.42f, 0.42f, 0.42f, 0.80f);
-    colors[ImGuiCol_FrameBgActive] = ImVec4(0.47f, 0.47f, 0.47f, 1.00f);
-    colors[ImGuiCol_TitleBg] = ImVec4(0.04f, 0.04f, 0.04f, 1.00f);
-    colors[ImGuiCol_TitleBgActive] = ImVec4(0.24f, 0.24f, 0.24f, 1.00f);
-    colors[ImGuiCol_TitleBgCollapsed] = ImVec4(0.00f, 0.00f, 0.00f, 0.51f);
-    colors[ImGuiCol_MenuBarBg] = ImVec4(0.14f, 0.14f, 0.14f, 1.00f);
-    colors[ImGuiCol_ScrollbarBg] = ImVec4(0.02f, 0.02f, 0.02f, 0.53f);
-    colors[ImGuiCol_ScrollbarGrab] = ImVec4(0.31f, 0.31f, 0.31f, 1.00f);
-    colors[ImGuiCol_ScrollbarGrabHovered] = ImVec4(0.41f, 0.41f, 0.41f, 1.00f);
-    colors[ImGuiCol_ScrollbarGrabActive] = ImVec4(0.51f, 0.51f, 0.51f, 1.00f);
-    colors[ImGuiCol_CheckMark] = ImVec4(0.33f, 1.00f, 0.00f, 1.00f);
-    colors[ImGuiCol_SliderGrab] = ImVec4(0.70f, 0.70f, 0.70f, 0.80f);
-    colors[ImGuiCol_SliderGrabActive] = ImVec4(0.76f, 0.76f, 0.76f, 1.00f);
-    colors[ImGuiCol_Button] = ImVec4(0.55f, 0.55f, 0.55f, 0.38f);
-    colors[ImGuiCol_ButtonHovered] = ImVec4(0.59f, 0.59f, 0.59f, 0.80f);
-    colors[ImGuiCol_ButtonActive] = ImVec4(0.63f, 0.63f, 0.63f, 1.00f);
-    colors[ImGuiCol_Header] = ImVec4(0.55f, 0.55f, 0.55f, 0.38f);
-    colors[ImGuiCol_HeaderHovered] = ImVec4(0.59f, 0.59f, 0.59f, 0.80f);
-    colors[ImGuiCol_HeaderActive] = ImVec4(0.63f, 0.63f, 0.63f, 1.00f);
-    colors[ImGuiCol_Separator] = colors[ImGuiCol_Border];
-    colors[ImGuiCol_SeparatorHovered] = ImVec4(0.10f, 0.40f, 0.75f, 0.78f);
-    colors[ImGuiCol_SeparatorActive] = ImVec4(0.10f, 0.40f, 0.75f, 1.00f);
-    colors[ImGuiCol_ResizeGrip] = ImVec4(0.26f, 0.59f, 0.98f, 0.25f);
-    colors[ImGuiCol_ResizeGripHovered] = ImVec4(0.26f, 0.59f, 0.98f, 0.67f);
-    colors[ImGuiCol_ResizeGripActive] = ImVec4(0.26f, 0.59f, 0.98f, 0.95f);
-    colors[ImGuiCol_Tab]
-        = Lerp(colors[ImGuiCol_Header], colors[ImGuiCol_TitleBgActive], 0.80f);
-    colors[ImGuiCol_TabHovered] = colors[ImGuiCol_HeaderHovered];
-    colors[ImGuiCol_TabActive]
-        = Lerp(colors[ImGuiCol_HeaderActive], colors[ImGuiCol_TitleBgActive], 0.60f);
-    colors[ImGuiCol_TabUnfocused]
-        = Lerp(colors[ImGuiCol_Tab], colors[ImGuiCol_TitleBg], 0.80f);
-    colors[ImGuiCol_TabUnfocusedActive]
-        = Lerp(colors[ImGuiCol_TabActive], colors[ImGuiCol_TitleBg], 0.40f);
-    colors[ImGuiCol_PlotLines] = ImVec4(0.61f, 0.61f, 0.61f, 1.00f);
-    colors[ImGuiCol_PlotLinesHovered] = ImVec4(1.00f, 0.43f, 0.35f, 1.00f);
-    colors[ImGuiCol_PlotHistogram] = ImVec4(0.90f, 0.70f, 0.00f, 1.00f);
-    colors[ImGuiCol_PlotHistogramHovered] = ImVec4(1.00f, 0.60f, 0.00f, 1.00f);
-    colors[ImGuiCol_TextSelectedBg] = ImVec4(0.63f, 0.63f, 0.63f, 0.35f);
-    colors[ImGuiCol_DragDropTarget] = ImVec4(1.00f, 1.00f, 0.00f, 0.90f);
-    colors[ImGuiCol_NavHighlight] = ImVec4(0.26f, 0.59f, 0.98f, 1.00f);
-    colors[ImGuiCol_NavWindowingHighlight] = ImVec4(1.00f, 1.00f, 1.00f, 0.70f);
-    colors[ImGuiCol_NavWindowingDimBg] = ImVec4(0.80f, 0.80f, 0.80f, 0.20f);
-    colors[ImGuiCol_ModalWindowDimBg] = ImVec4(0.80f, 0.80f, 0.80f, 0.35f);
+    if (m_lineCapCache.weight != style.m_strokeWeight || m_lineCapCache.cap != style.m_lineCap) {
+        updateLineCapCache(style.m_strokeWeight, style.m_lineCap);
+    }
 
-    auto& style = ImGui::GetStyle();
-    style.FrameRounding = 8.0f;
-    style.WindowRounding = 10.0f;
-    style.ScrollbarRounding = 8.0f;
-    style.PopupRounding = 8.0f;
-    style.GrabRounding = 10.0f;
+    float length = dist(x1, y1, x2, y2);
+    sf::Vector2f direction = { 1.f, 0.f };
+    if (length != 0.f) {
+        direction = { (x2 - x1) / length, (y2 - y1) / length };
+    }
+    sf::Vector2f normal = { -direction.y, direction.x };
+
+    // One strip for the whole line: Every row connects a point of the start cap with the
+    // mirrored point of the end cap, the first and the last row are the long sides of the line.
+    const auto& offsets = m_lineCapCache.offsets;
+    countGrowth(m_shapePoints, offsets.size() * 2, m_frameStats);
+    m_shapePoints.resize(offsets.size() * 2);
+    for (size_t i = 0; i < offsets.size(); i++) {
+        float along = offsets[i].x;
+        float across = offsets[i].y;
+        m_shapePoints[i * 2] = { x1 - direction.x * along + normal.x * across,
+                                 y1 - direction.y * along + normal.y * across };
+        m_shapePoints[i * 2 + 1] = { x2 + direction.x * along + normal.x * across,
+                                     y2 + direction.y * along + normal.y * across };
+    }
+    m_renderer->strip(m_shapePoints.data(), m_shapePoints.size(), style.m_strokeColor);
 }
 
-void App::run()
+void App::drawRect(const DrawStyle& style, float x, float y, float w, float h)
 {
-    sf::ContextSettings settings;
-    settings.antialiasingLevel = 8.0;
-
-    updateDisplaySize();
-    setup();
-
-    window.create(sf::VideoMode({ width, height }), title, sf::Style::Default, settings);
-    window.setFramerateLimit(60);
-    auto pngData = decodeBase64(CPP_LOGO_BASE64);
-    sf::Image icon;
-    if (icon.loadFromMemory(pngData.data(), pngData.size())) {
-        window.setIcon(icon.getSize().x, icon.getSize().y, icon.getPixelsPtr());
+    if (style.m_rectMode == RectMode::Center) {
+        x -= w / 2.0f;
+        y -= h / 2.0f;
     }
-
-    if (!ImGui::SFML::Init(window)) {
-        throw std::runtime_error("[cppgfx]: Failed to initialize ImGui");
+    else if (style.m_rectMode == RectMode::Corner) {
+        // Do nothing
     }
-    LoadDefaultImGuiStyle();
-
-    ImFontConfig font_cfg;
-    font_cfg.FontDataOwnedByAtlas = false;
-    ImGui::GetIO().Fonts->AddFontFromMemoryTTF(
-        (void*)ROBOTO_MEDIUM_DATA, ROBOTO_MEDIUM_SIZE, 18.0f, &font_cfg);
-
-    if (!ImGui::SFML::UpdateFontTexture()) {
-        throw std::runtime_error("[cppgfx]: Failed to update ImGui font texture");
+    else if (style.m_rectMode == RectMode::Corners) {
+        w -= x;
+        h -= y;
     }
-    ImGui::GetIO().FontDefault = ImGui::GetIO().Fonts->Fonts.back();
+    else {
+        throw std::runtime_error("Unknown rect mode");
+    }
+    sf::Vector2f corners[4] = { { x, y }, { x + w, y }, { x + w, y + h }, { x, y + h } };
+    drawShape(corners, 4, style.m_fillColor, style.m_strokeColor, style.m_strokeWeight);
+}
 
-    while (window.isOpen() && !m_windowShouldClose) {
+void App::drawCircle(const DrawStyle& style, float x, float y, float radius)
+{
+    const auto& unit = unitCircle(circleSegments(radius));
+    size_t count = unit.size();
 
-        // Handle dark title bar
-        if (darkTitleBar != m_isDarkTitleBar) {
-#ifdef _WIN32
-            Win32EnableDarkTitleBar(window.getSystemHandle(), darkTitleBar);
-#else
-#error "Dark title bar is only supported on Windows"
-#endif
-            m_isDarkTitleBar = darkTitleBar;
+    countGrowth(m_shapePoints, count, m_frameStats);
+    m_shapePoints.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        m_shapePoints[i] = { x + unit[i].x * radius, y + unit[i].y * radius };
+    }
+    m_renderer->convex(m_shapePoints.data(), count, style.m_fillColor);
+
+    // Same as the outline of sf::Shape: The corners are offset by the miter length, which is constant for a circle
+    if (style.m_strokeWeight != 0) {
+        float outerRadius = radius + style.m_strokeWeight / cosf(PI / static_cast<float>(count));
+        countGrowth(m_outlinePoints, count, m_frameStats);
+        m_outlinePoints.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            m_outlinePoints[i] = { x + unit[i].x * outerRadius, y + unit[i].y * outerRadius };
         }
+        m_renderer->ring(m_outlinePoints.data(), m_shapePoints.data(), count, style.m_strokeColor);
+    }
+}
 
-        // Prepare data
-        updateDisplaySize();
-        focused = window.hasFocus();
-        frameTime = m_frametimeClock.restart().asSeconds();
-        frameRate = 1.0f / frameTime;
-        pmouseX = mouseX;
-        pmouseY = mouseY;
-        mouseX = sf::Mouse::getPosition(window).x;
-        mouseY = sf::Mouse::getPosition(window).y;
-        dmouseX = mouseX - pmouseX;
-        dmouseY = mouseY - pmouseY;
-        mousePressed = sf::Mouse::isButtonPressed(sf::Mouse::Left)
-            || sf::Mouse::isButtonPressed(sf::Mouse::Right);
-
-        // Handle events
-        sf::Event event {};
-        while (window.pollEvent(event)) {
-            ImGui::SFML::ProcessEvent(window, event);
-            switch (event.type) {
-
-            case sf::Event::TextEntered:
-                onTextInput(event.text);
-                break;
-
-            case sf::Event::KeyPressed:
-                onKeyPressed(event.key);
-                break;
-
-            case sf::Event::KeyReleased:
-                onKeyReleased(event.key);
-                break;
-
-            case sf::Event::MouseButtonPressed:
-                onMousePressed(event.mouseButton);
-                break;
-
-            case sf::Event::MouseButtonReleased:
-                onMouseReleased(event.mouseButton);
-                break;
-
-            case sf::Event::MouseMoved:
-                onMouseMoved(event.mouseMove);
-                break;
-
-            case sf::Event::MouseWheelScrolled:
-                onMouseWheel(event.mouseWheelScroll);
-                break;
-
-            case sf::Event::MouseEntered:
-                onMouseEnter();
-                break;
-
-            case sf::Event::MouseLeft:
-                onMouseLeave();
-                break;
-
-            case sf::Event::Closed:
-                if (onWindowClose()) {
-                    window.close();
-                }
-                break;
-
-            case sf::Event::Resized:
-                width = event.size.width;
-                height = event.size.height;
-                onWindowResize();
-                break;
+void App::drawPoint(const DrawStyle& style, float x, float y)
+{
+    // A point is a dot in the stroke color, with the stroke weight as its diameter.
+    // Very small dots are drawn as squares, which is indistinguishable from a circle.
+    float radius = style.m_strokeWeight / 2.0f;
+    if (radius <= 1.0f) {
+        radius = std::max(radius, 0.5f);
+        sf::Vector2f corners[4] = {
+            { x - radius, y - radius }, { x + radius, y - radius },
+            { x + radius, y + radius }, { x - radius, y + radius }
+        };
+        m_renderer->convex(corners, 4, style.m_strokeColor);
+        return;
+    }
 
-            case sf::Event::GainedFocus:
-                onWindowFocus();
-                break;
+    const auto& unit = unitCircle(circleSegments(radius));
+    countGrowth(m_shapePoints, unit.size(), m_frameStats);
+    m_shapePoints.resize(unit.size());
+    for (size_t i = 0; i < unit.size(); i++) {
+        m_shapePoints[i] = { x + unit[i].x * radius, y + unit[i].y * radius };
+    }
+    m_renderer->convex(m_shapePoints.data(), m_shapePoints.size(), style.m_strokeColor);
+}
 
-            case sf::Event::LostFocus:
-                onWindowUnfocus();
-                break;
+const std::vector<sf::Vector2f>& App::unitCircle(size_t segments)
+{
+    if (m_unitCircles.size() <= segments) {
+        countGrowth(m_unitCircles, segments + 1, m_frameStats);
+        m_unitCircles.resize(segments + 1);
+    }
 
-            default:
-                break;
-            }
+    // Starts at the top, like sf::CircleShape
+    auto& table = m_unitCircles[segments];
+    if (table.empty()) {
+        countGrowth(table, segments, m_frameStats);
+        table.resize(segments);
+        for (size_t i = 0; i < segments; i++) {
+            float angle = static_cast<float>(i) * 2.0f * PI / static_cast<float>(segments) - PI / 2.0f;
+            table[i] = { cosf(angle), sinf(angle) };
         }
-
-        // Call the user's update function
-        ImGui::SFML::Update(window, m_frametimeClock.restart());
-        window.clear(m_defaultBackgroundColor);
-        stroke(0, 0, 0);
-        strokeWeight(2);
-        fill(255, 255, 255);
-        update();
-        ImGui::SFML::Render(window);
-
-        // Display the window
-        window.display();
-
-        // Post update
-        frameCount++;
     }
-
-    // Call the user defined cleanup
-    cleanup();
-
-    ImGui::SFML::Shutdown();
+    return table;
 }
 
-// =======================================
-// =====           Private        ========
-// =======================================
-
-void App::updateDisplaySize()
+void App::drawShape(const sf::Vector2f* points,
+                    size_t count,
+                    const sf::Color& fill,
+                    const sf::Color& stroke,
+                    float weight)
 {
-    displayWidth = sf::VideoMode::getDesktopMode().width;
-    displayHeight = sf::VideoMode::getDesktopMode().height;
+    m_renderer->convex(points, count, fill);
+    if (weight != 0) {
+        countGrowth(m_outlinePoints, count, m_frameStats);
+        m_outlinePoints.resize(count);
+        computeOutline(points, count, weight, m_outlinePoints.data());
+        m_renderer->ring(m_outlinePoints.data(), points, count, stroke);
+    }
 }
 
 } // namespace cppgfx
@@ -0,0 +1,114 @@
+
+#include "cppgfx/framepacer.hpp"
+
+#include "SFML/System.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace cppgfx {
+
+// The sleep margin follows the overshoot of the operating system's sleep, within these bounds
+static constexpr std::chrono::microseconds MIN_SLEEP_MARGIN { 200 };
+static constexpr std::chrono::microseconds MAX_SLEEP_MARGIN { 4000 };
+
+void FramePacer::setRate(double framesPerSecond)
+{
+    m_rate = (framesPerSecond > 0) ? framesPerSecond : 0;
+    m_period = (m_rate > 0)
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_rate))
+        : Clock::duration::zero();
+    reset();
+}
+
+void FramePacer::reset()
+{
+    m_scheduled = false;
+}
+
+void FramePacer::wait()
+{
+    if (m_rate <= 0) {
+        return;
+    }
+
+    auto now = Clock::now();
+    if (!m_scheduled) {
+        // The schedule starts with the current frame, which is never late
+        m_deadline = now + m_period;
+        m_scheduled = true;
+        return;
+    }
+
+    // Sleep for the coarse part, the sleep of the operating system can overshoot by a millisecond or more
+    auto remaining = m_deadline - now;
+    if (remaining > m_sleepMargin) {
+        auto sleepTime = std::chrono::duration_cast<std::chrono::microseconds>(remaining - m_sleepMargin);
+        auto sleepEnd = now + sleepTime;
+        sf::sleep(sf::microseconds(sleepTime.count()));
+        now = Clock::now();
+
+        // Grow the margin right away when the sleep was too long, and shrink it slowly when it was precise
+        auto overshoot = std::chrono::duration_cast<Clock::duration>(now - sleepEnd + MIN_SLEEP_MARGIN);
+        if (overshoot > m_sleepMargin) {
+            m_sleepMargin = std::min<Clock::duration>(overshoot, MAX_SLEEP_MARGIN);
+        }
+        else {
+            m_sleepMargin = std::max<Clock::duration>(m_sleepMargin - m_sleepMargin / 64, MIN_SLEEP_MARGIN);
+        }
+    }
+
+    // Yield for the fine part, until the deadline is reached
+    while (now < m_deadline) {
+        std::this_thread::yield();
+        now = Clock::now();
+    }
+
+    auto lateness = now - m_deadline;
+    bool missed = lateness >= m_period;
+    record(lateness, missed);
+
+    // The next deadline is one period after this one, so that being a little late does not add up.
+    // Frames that are very late, or delayed by the display, restart the schedule instead of catching up.
+    if (missed || (m_verticalSync && lateness > MIN_SLEEP_MARGIN)) {
+        m_deadline = now + m_period;
+    }
+    else {
+        m_deadline += m_period;
+    }
+}
+
+void FramePacer::record(Clock::duration lateness, bool missed)
+{
+    m_lateness[m_next] = std::chrono::duration<float, std::milli>(lateness).count();
+    m_missed[m_next] = missed;
+    m_next = (m_next + 1) % HISTORY_SIZE;
+    m_count = std::min(m_count + 1, HISTORY_SIZE);
+}
+
+PacingStats FramePacer::stats() const
+{
+    PacingStats stats;
+    stats.targetFrameTime = (m_rate > 0) ? 1000.0 / m_rate : 0.0;
+    if (m_count == 0) {
+        return stats;
+    }
+
+    // The order does not matter for the statistics, so the ring buffer is used as it is
+    m_sorted.assign(m_lateness.begin(), m_lateness.begin() + static_cast<std::ptrdiff_t>(m_count));
+    std::sort(m_sorted.begin(), m_sorted.end());
+
+    double sum = 0;
+    for (float lateness : m_sorted) {
+        sum += lateness;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(0.99 * static_cast<double>(m_count)));
+    stats.meanLateness = sum / static_cast<double>(m_count);
+    stats.p99Lateness = m_sorted[std::clamp<size_t>(rank, 1, m_count) - 1];
+    stats.maxLateness = m_sorted.back();
+    stats.missedDeadlines = static_cast<size_t>(std::count(m_missed.begin(), m_missed.begin() + m_count, true));
+    return stats;
+}
+
+} // namespace cppgfx
@@ -0,0 +1,178 @@
+
+#include "cppgfx/frameprofiler.hpp"
+#include "cppgfx/profiler.hpp"
+
+#include "imgui.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cppgfx {
+
+static const char* const PHASE_NAMES[] = { "Events", "Update", "Flush", "ImGui", "Display" };
+static const ImU32 PHASE_COLORS[] = {
+    IM_COL32(90, 160, 230, 255),
+    IM_COL32(240, 180, 40, 255),
+    IM_COL32(120, 200, 90, 255),
+    IM_COL32(200, 110, 220, 255),
+    IM_COL32(230, 90, 80, 255),
+};
+
+static float milliseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<float, std::milli>(duration).count();
+}
+
+// The phases also appear as zones in the trace, so that user zones can be seen in the context of the frame
+static void recordZone([[maybe_unused]] const char* name,
+                       [[maybe_unused]] std::chrono::steady_clock::time_point begin,
+                       [[maybe_unused]] std::chrono::steady_clock::time_point end)
+{
+#ifdef CPPGFX_PROFILER
+    auto nanoseconds = [](std::chrono::steady_clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    };
+    profilerRecord(name, nanoseconds(begin), nanoseconds(end));
+#endif
+}
+
+void FrameProfiler::beginFrame()
+{
+    m_current = Frame();
+    m_frameStart = Clock::now();
+    m_phaseStart = m_frameStart;
+}
+
+void FrameProfiler::endPhase(FramePhase phase)
+{
+    auto now = Clock::now();
+    m_current.phases[static_cast<size_t>(phase)] += milliseconds(now - m_phaseStart);
+    recordZone(PHASE_NAMES[static_cast<size_t>(phase)], m_phaseStart, now);
+    m_phaseStart = now;
+}
+
+void FrameProfiler::endFrame()
+{
+    auto now = Clock::now();
+    m_current.total = milliseconds(now - m_frameStart);
+    recordZone("Frame", m_frameStart, now);
+    m_frames[m_next] = m_current;
+    m_next = (m_next + 1) % HISTORY_SIZE;
+    m_count = std::min(m_count + 1, HISTORY_SIZE);
+}
+
+const FrameProfiler::Frame& FrameProfiler::frame(size_t index) const
+{
+    size_t oldest = (m_next + HISTORY_SIZE - m_count) % HISTORY_SIZE;
+    return m_frames[(oldest + index) % HISTORY_SIZE];
+}
+
+float FrameProfiler::phaseTime(size_t index, FramePhase phase) const
+{
+    return frame(index).phases[static_cast<size_t>(phase)];
+}
+
+float FrameProfiler::frameTime(size_t index) const
+{
+    return frame(index).total;
+}
+
+FrameProfiler::Summary FrameProfiler::summary() const
+{
+    Summary summary;
+    if (m_count == 0) {
+        return summary;
+    }
+
+    m_sorted.clear();
+    for (size_t i = 0; i < m_count; i++) {
+        m_sorted.push_back(frameTime(i));
+    }
+    std::sort(m_sorted.begin(), m_sorted.end());
+
+    // Nearest-rank percentiles
+    auto percentile = [this](float p) {
+        size_t rank = static_cast<size_t>(std::ceil(p * static_cast<float>(m_sorted.size())));
+        return m_sorted[std::clamp<size_t>(rank, 1, m_sorted.size()) - 1];
+    };
+
+    float sum = 0;
+    for (float time : m_sorted) {
+        sum += time;
+    }
+    summary.min = m_sorted.front();
+    summary.avg = sum / static_cast<float>(m_sorted.size());
+    summary.p95 = percentile(0.95f);
+    summary.p99 = percentile(0.99f);
+    summary.max = m_sorted.back();
+    return summary;
+}
+
+void FrameProfiler::drawOverlay(const FrameStats& stats) const
+{
+    constexpr float BAR_WIDTH = 2.f;
+    constexpr float GRAPH_HEIGHT = 120.f;
+    constexpr float TARGET_FRAME_TIME = 1000.f / 60.f;
+
+    ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowBgAlpha(0.85f);
+    ImGuiWindowFlags flags = ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings
+        | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav;
+    if (!ImGui::Begin("Frame profiler", nullptr, flags)) {
+        ImGui::End();
+        return;
+    }
+
+    Summary times = summary();
+    ImGui::Text("Frame time [ms]  min %.2f  avg %.2f  p95 %.2f  p99 %.2f  max %.2f",
+                times.min, times.avg, times.p95, times.p99, times.max);
+
+    // Stacked bars with the newest frame on the right, scaled so that a 60 FPS frame is always visible
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    float graphWidth = BAR_WIDTH * static_cast<float>(HISTORY_SIZE);
+    float scale = GRAPH_HEIGHT / std::max(times.max, TARGET_FRAME_TIME * 1.25f);
+    float bottom = origin.y + GRAPH_HEIGHT;
+    drawList->AddRectFilled(origin, ImVec2(origin.x + graphWidth, bottom), IM_COL32(20, 20, 20, 200));
+
+    float left = origin.x + graphWidth - BAR_WIDTH * static_cast<float>(m_count);
+    for (size_t i = 0; i < m_count; i++) {
+        float x = left + BAR_WIDTH * static_cast<float>(i);
+        float y = bottom;
+        for (size_t phase = 0; phase < static_cast<size_t>(FramePhase::Count); phase++) {
+            float height = phaseTime(i, static_cast<FramePhase>(phase)) * scale;
+            drawList->AddRectFilled(ImVec2(x, y - height), ImVec2(x + BAR_WIDTH, y), PHASE_COLORS[phase]);
+            y -= height;
+        }
+    }
+
+    float target = bottom - TARGET_FRAME_TIME * scale;
+    drawList->AddLine(ImVec2(origin.x, target), ImVec2(origin.x + graphWidth, target), IM_COL32(255, 255, 255, 120));
+    ImGui::Dummy(ImVec2(graphWidth, GRAPH_HEIGHT));
+
+    // Legend with the average time of every phase
+    for (size_t phase = 0; phase < static_cast<size_t>(FramePhase::Count); phase++) {
+        float sum = 0;
+        for (size_t i = 0; i < m_count; i++) {
+            sum += phaseTime(i, static_cast<FramePhase>(phase));
+        }
+        float average = (m_count > 0) ? sum / static_cast<float>(m_count) : 0.f;
+        ImGui::ColorButton(PHASE_NAMES[phase],
+                           ImGui::ColorConvertU32ToFloat4(PHASE_COLORS[phase]),
+                           ImGuiColorEditFlags_NoTooltip,
+                           ImVec2(10, 10));
+        ImGui::SameLine();
+        ImGui::Text("%-8s %6.2f ms", PHASE_NAMES[phase], average);
+    }
+
+    // Counters of the last frame
+    ImGui::Separator();
+    ImGui::Text("Draw calls %zu  Texture binds %zu", stats.drawCalls, stats.textureBinds);
+    ImGui::Text("Vertices %zu  Triangles %zu", stats.vertices, stats.triangles);
+    ImGui::Text("Texts %zu  Glyphs laid out %zu", stats.textDraws, stats.glyphsLaidOut);
+    ImGui::Text("Pushes %zu  Pops %zu  Allocations %zu", stats.stylePushes, stats.stylePops, stats.allocations);
+
+    ImGui::End();
+}
+
+} // namespace cppgfx
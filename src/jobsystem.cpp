@@ -0,0 +1,159 @@
+
+#include "cppgfx/jobsystem.hpp"
+
+namespace cppgfx {
+
+// Workers know their pool and queue, so that jobs submitted from a job go to the queue of its worker
+static thread_local const JobSystem* t_system = nullptr;
+static thread_local size_t t_queue = 0;
+
+JobSystem::JobSystem(size_t threads)
+{
+    if (threads == 0) {
+        size_t hardware = std::thread::hardware_concurrency();
+        threads = (hardware > 1) ? hardware - 1 : 1;
+    }
+
+    for (size_t i = 0; i <= threads; i++) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 1; i <= threads; i++) {
+        m_threads.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+std::shared_ptr<JobSystem> JobSystem::shared()
+{
+    // Only a weak reference is kept, so that the workers stop before the end of the program
+    static std::mutex mutex;
+    static std::weak_ptr<JobSystem> pool;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<JobSystem> system = pool.lock();
+    if (!system) {
+        system = std::make_shared<JobSystem>();
+        pool = system;
+    }
+    return system;
+}
+
+JobSystem::~JobSystem()
+{
+    waitAll();
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void JobSystem::wait(const JobGroup& group)
+{
+    CPPGFX_PROFILE_SCOPE("wait");
+    helpUntil([&group] { return group.isDone(); });
+}
+
+void JobSystem::waitAll()
+{
+    CPPGFX_PROFILE_SCOPE("waitAll");
+    helpUntil([this] { return m_unfinished.load(std::memory_order_acquire) == 0; });
+}
+
+size_t JobSystem::queueIndex() const
+{
+    return (t_system == this) ? t_queue : 0;
+}
+
+void JobSystem::pushJob(std::unique_ptr<Job> job)
+{
+    // The counters are raised first, so that they never drop below the number of jobs in the queues
+    m_unfinished.fetch_add(1, std::memory_order_relaxed);
+    m_queued.fetch_add(1, std::memory_order_relaxed);
+    Queue& queue = *m_queues[queueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+
+    // Locking once makes sure that a thread which is about to sleep either sees the job or gets the notification
+    bool waiters = false;
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        waiters = m_waiters.load(std::memory_order_relaxed) > 0;
+    }
+    m_wake.notify_one();
+    if (waiters) {
+        m_progress.notify_all();
+    }
+}
+
+bool JobSystem::runOne()
+{
+    if (m_queued.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    // The newest job of the own queue is likely still in the cache, jobs of other queues are stolen from the front.
+    // The shared queue is always run from the front, so that the oldest submissions are not starved.
+    size_t own = queueIndex();
+    std::unique_ptr<Job> job;
+    for (size_t i = 0; i < m_queues.size() && !job; i++) {
+        Queue& queue = *m_queues[(own + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) {
+            continue;
+        }
+        if (i == 0 && own != 0) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+        }
+        else {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+        }
+    }
+    if (!job) {
+        return false;
+    }
+    m_queued.fetch_sub(1, std::memory_order_relaxed);
+
+    {
+        CPPGFX_PROFILE_SCOPE("Job");
+        job->run();
+        job.reset();
+    }
+    m_unfinished.fetch_sub(1, std::memory_order_release);
+
+    // A thread in helpUntil() may wait for exactly this job, see there
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_waiters.load(std::memory_order_relaxed) > 0) {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+        }
+        m_progress.notify_all();
+    }
+    return true;
+}
+
+void JobSystem::workerLoop(size_t index)
+{
+    t_system = this;
+    t_queue = index;
+
+    while (true) {
+        if (runOne()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this] { return m_stop || m_queued.load(std::memory_order_acquire) > 0; });
+        if (m_stop) {
+            return;
+        }
+    }
+}
+
+} // namespace cppgfx
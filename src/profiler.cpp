@@ -0,0 +1,216 @@
+
+#include "cppgfx/profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace cppgfx {
+
+// =======================================
+// =====       Thread buffers     ========
+// =======================================
+
+struct Zone {
+    const char* name;
+    int64_t begin;
+    int64_t end;
+};
+
+// A zone in the ring buffer. Readers copy slots while the owning thread may overwrite them, so every field is
+// atomic. Relaxed accesses compile to plain moves, the ordering comes from the fences around them.
+struct ZoneSlot {
+    std::atomic<const char*> name;
+    std::atomic<int64_t> begin;
+    std::atomic<int64_t> end;
+};
+
+// A ring buffer with a single writer, the thread that owns it. Readers copy the zones and afterwards discard
+// everything that might have been overwritten in the meantime, so the writer never has to wait.
+struct ThreadBuffer {
+    uint32_t id = 0;
+    std::unique_ptr<ZoneSlot[]> zones = std::make_unique<ZoneSlot[]>(CPPGFX_PROFILER_BUFFER_SIZE);
+    std::atomic<uint64_t> head { 0 };
+    std::atomic<uint64_t> start { 0 };
+};
+
+// Every buffer that was ever created, and those whose thread has exited. A new thread takes a free buffer
+// before a new one is allocated, so the memory only grows with the number of threads that run at the same time.
+// The zones of an exited thread remain in the trace until its buffer is taken again.
+static std::mutex s_buffersMutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+static std::vector<ThreadBuffer*> s_freeBuffers;
+static uint32_t s_nextThreadId = 1;
+
+// Owns the buffer of one thread and hands it back when the thread exits
+class ThreadBufferOwner {
+public:
+    ThreadBufferOwner()
+    {
+        std::lock_guard<std::mutex> lock(s_buffersMutex);
+        if (s_freeBuffers.empty()) {
+            s_buffers.push_back(std::make_unique<ThreadBuffer>());
+            m_buffer = s_buffers.back().get();
+        }
+        else {
+            m_buffer = s_freeBuffers.back();
+            s_freeBuffers.pop_back();
+        }
+
+        // The zones of the previous thread would appear under the new id otherwise
+        m_buffer->id = s_nextThreadId++;
+        m_buffer->start.store(m_buffer->head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    ~ThreadBufferOwner()
+    {
+        std::lock_guard<std::mutex> lock(s_buffersMutex);
+        s_freeBuffers.push_back(m_buffer);
+    }
+
+    ThreadBufferOwner(const ThreadBufferOwner&) = delete;
+    ThreadBufferOwner& operator=(const ThreadBufferOwner&) = delete;
+
+    ThreadBuffer& buffer() { return *m_buffer; }
+
+private:
+    ThreadBuffer* m_buffer = nullptr;
+};
+
+static ThreadBuffer& threadBuffer()
+{
+    thread_local ThreadBufferOwner owner;
+    return owner.buffer();
+}
+
+static std::vector<Zone> copyZones(const ThreadBuffer& buffer)
+{
+    constexpr uint64_t capacity = CPPGFX_PROFILER_BUFFER_SIZE;
+    uint64_t head = buffer.head.load(std::memory_order_acquire);
+    uint64_t first = std::max(buffer.start.load(std::memory_order_relaxed), head > capacity ? head - capacity : 0);
+
+    std::vector<Zone> zones;
+    zones.reserve(head - first);
+    for (uint64_t i = first; i < head; i++) {
+        const ZoneSlot& slot = buffer.zones[i % capacity];
+        zones.push_back({ slot.name.load(std::memory_order_relaxed),
+                          slot.begin.load(std::memory_order_relaxed),
+                          slot.end.load(std::memory_order_relaxed) });
+    }
+
+    // Pairs with the fence in profilerRecord(): if a slot was overwritten while copying, the head read
+    // below includes that write. The slot of the zone that is currently written and all slots before it
+    // may have changed.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t headAfter = buffer.head.load(std::memory_order_relaxed);
+    if (headAfter + 1 > first + capacity) {
+        uint64_t overwritten = std::min<uint64_t>(headAfter + 1 - capacity - first, zones.size());
+        zones.erase(zones.begin(), zones.begin() + static_cast<std::ptrdiff_t>(overwritten));
+    }
+    return zones;
+}
+
+// =======================================
+// =====          Recording       ========
+// =======================================
+
+int64_t profilerTimestamp()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+void profilerRecord(const char* name, int64_t begin, int64_t end)
+{
+    ThreadBuffer& buffer = threadBuffer();
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    ZoneSlot& slot = buffer.zones[head % CPPGFX_PROFILER_BUFFER_SIZE];
+
+    // Readers that see any of the new fields also see the head before this write, see copyZones()
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.begin.store(begin, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void profilerClear()
+{
+    std::lock_guard<std::mutex> lock(s_buffersMutex);
+    for (auto& buffer : s_buffers) {
+        buffer->start.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+// =======================================
+// =====         Trace export     ========
+// =======================================
+
+static void writeJsonString(std::ostream& out, const char* text)
+{
+    static const char* const HEX = "0123456789abcdef";
+    out << '"';
+    for (const char* c = text; *c != '\0'; c++) {
+        auto byte = static_cast<unsigned char>(*c);
+        if (byte == '"' || byte == '\\') {
+            out << '\\' << *c;
+        }
+        else if (byte < 0x20) {
+            out << "\\u00" << HEX[byte >> 4] << HEX[byte & 0xF];
+        }
+        else {
+            out << *c;
+        }
+    }
+    out << '"';
+}
+
+// Chrome expects microseconds, the fraction keeps the nanosecond resolution
+static void writeMicros(std::ostream& out, int64_t nanoseconds)
+{
+    out << nanoseconds / 1000 << '.' << static_cast<char>('0' + nanoseconds / 100 % 10)
+        << static_cast<char>('0' + nanoseconds / 10 % 10) << static_cast<char>('0' + nanoseconds % 10);
+}
+
+void profilerWriteTrace(std::ostream& out)
+{
+    std::vector<std::pair<uint32_t, std::vector<Zone>>> threads;
+    {
+        std::lock_guard<std::mutex> lock(s_buffersMutex);
+        for (auto& buffer : s_buffers) {
+            threads.emplace_back(buffer->id, copyZones(*buffer));
+        }
+    }
+
+    // Timestamps are relative to the first zone, so that they stay readable
+    int64_t origin = INT64_MAX;
+    for (auto& [id, zones] : threads) {
+        for (auto& zone : zones) {
+            origin = std::min(origin, zone.begin);
+        }
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (auto& [id, zones] : threads) {
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << id
+            << ",\"args\":{\"name\":\"Thread " << id << "\"}}";
+        first = false;
+
+        for (auto& zone : zones) {
+            out << ",\n{\"name\":";
+            writeJsonString(out, zone.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << id << ",\"ts\":";
+            writeMicros(out, zone.begin - origin);
+            out << ",\"dur\":";
+            writeMicros(out, std::max<int64_t>(zone.end - zone.begin, 0));
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+}
+
+} // namespace cppgfx
@@ -0,0 +1,166 @@
+
+#include "cppgfx/sfmlrenderer.hpp"
+
+namespace cppgfx {
+
+// Font pages keep a 2x2 white square in their top left corner, sampling its center gives plain white
+static const sf::Vector2f WHITE_TEXEL = { 1.f, 1.f };
+
+SfmlRenderer::SfmlRenderer(sf::RenderTarget& target)
+    : m_target(target)
+{
+}
+
+void SfmlRenderer::clear(const sf::Color& color)
+{
+    // Everything that is still pending would be painted over anyway
+    discard();
+    m_target.clear(color);
+}
+
+void SfmlRenderer::discard()
+{
+    m_vertices.clear();
+    m_pendingGlyphs = false;
+}
+
+void SfmlRenderer::convex(const sf::Vector2f* points, size_t count, const sf::Color& color)
+{
+    if (count < 3 || color.a == 0) {
+        return;
+    }
+
+    // Triangle fan around the first point
+    sf::Vertex* v = allocate((count - 2) * 3);
+    m_stats->triangles += count - 2;
+    for (size_t i = 1; i + 1 < count; i++) {
+        *v++ = sf::Vertex(points[0], color, WHITE_TEXEL);
+        *v++ = sf::Vertex(points[i], color, WHITE_TEXEL);
+        *v++ = sf::Vertex(points[i + 1], color, WHITE_TEXEL);
+    }
+}
+
+void SfmlRenderer::strip(const sf::Vector2f* points, size_t count, const sf::Color& color)
+{
+    if (count < 3 || color.a == 0) {
+        return;
+    }
+
+    sf::Vertex* v = allocate((count - 2) * 3);
+    m_stats->triangles += count - 2;
+    for (size_t i = 2; i < count; i++) {
+        *v++ = sf::Vertex(points[i - 2], color, WHITE_TEXEL);
+        *v++ = sf::Vertex(points[i - 1], color, WHITE_TEXEL);
+        *v++ = sf::Vertex(points[i], color, WHITE_TEXEL);
+    }
+}
+
+void SfmlRenderer::ring(const sf::Vector2f* outer,
+                        const sf::Vector2f* inner,
+                        size_t count,
+                        const sf::Color& color)
+{
+    if (count < 2 || color.a == 0) {
+        return;
+    }
+
+    // Closed triangle strip between both outlines, two triangles per segment
+    sf::Vertex* v = allocate(count * 6);
+    m_stats->triangles += count * 2;
+    for (size_t i = 0; i < count; i++) {
+        size_t next = (i + 1 == count) ? 0 : i + 1;
+        *v++ = sf::Vertex(inner[i], color, WHITE_TEXEL);
+        *v++ = sf::Vertex(outer[i], color, WHITE_TEXEL);
+        *v++ = sf::Vertex(inner[next], color, WHITE_TEXEL);
+        *v++ = sf::Vertex(inner[next], color, WHITE_TEXEL);
+        *v++ = sf::Vertex(outer[i], color, WHITE_TEXEL);
+        *v++ = sf::Vertex(outer[next], color, WHITE_TEXEL);
+    }
+}
+
+void SfmlRenderer::text(const std::string& text,
+                        const sf::Vector2f& position,
+                        float align,
+                        const TextStyle& style)
+{
+    const TextLayout& layout
+        = m_textCache.get(text, *style.font, style.fontId, style.characterSize, style.outlineThickness, *m_stats);
+
+    // The text is positioned by the top of its bounds, not by its baseline
+    sf::Vector2f offset = { position.x - layout.bounds.width * align, position.y - layout.bounds.top };
+
+    const sf::Texture& texture = style.font->getTexture(style.characterSize);
+    glyphs(layout.vertices.data(), layout.outlineVertexCount, offset, style.outlineColor, texture);
+    glyphs(layout.vertices.data() + layout.outlineVertexCount,
+           layout.vertices.size() - layout.outlineVertexCount,
+           offset,
+           style.fillColor,
+           texture);
+}
+
+void SfmlRenderer::textWidths(const std::string* texts, size_t count, const TextStyle& style, float* widths)
+{
+    m_textMetrics.widths(texts, count, *style.font, style.fontId, style.characterSize, widths);
+}
+
+void SfmlRenderer::glyphs(const sf::Vertex* vertices,
+                          size_t count,
+                          const sf::Vector2f& offset,
+                          const sf::Color& color,
+                          const sf::Texture& texture)
+{
+    if (count == 0 || color.a == 0) {
+        return;
+    }
+
+    setTexture(&texture);
+    m_pendingGlyphs = true;
+    sf::Vertex* v = allocate(count);
+    m_stats->triangles += count / 3;
+    for (size_t i = 0; i < count; i++) {
+        v[i] = sf::Vertex(vertices[i].position + offset, color, vertices[i].texCoords);
+    }
+}
+
+void SfmlRenderer::flush()
+{
+    if (m_vertices.empty()) {
+        return;
+    }
+    m_target.draw(m_vertices.data(), m_vertices.size(), sf::PrimitiveType::Triangles, m_states);
+    m_stats->drawCalls++;
+    m_stats->vertices += m_vertices.size();
+    m_vertices.clear();
+    m_pendingGlyphs = false;
+}
+
+void SfmlRenderer::forgetFont(uint32_t fontId)
+{
+    m_textCache.forget(fontId);
+    m_textMetrics.forget(fontId);
+
+    // The pages of the new font may be allocated where the old ones were
+    m_states.texture = nullptr;
+}
+
+void SfmlRenderer::setTexture(const sf::Texture* texture)
+{
+    // Pending shapes look the same with any font page, only pending glyphs tie the batch to its texture
+    if (m_states.texture != texture) {
+        if (m_pendingGlyphs) {
+            flush();
+        }
+        m_states.texture = texture;
+        m_stats->textureBinds++;
+    }
+}
+
+sf::Vertex* SfmlRenderer::allocate(size_t count)
+{
+    size_t offset = m_vertices.size();
+    countGrowth(m_vertices, offset + count, *m_stats);
+    m_vertices.resize(offset + count);
+    return m_vertices.data() + offset;
+}
+
+} // namespace cppgfx
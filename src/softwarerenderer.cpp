@@ -0,0 +1,565 @@
+
+#include "cppgfx/softwarerenderer.hpp"
+#include "cppgfx/softwareblend.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+// The glyph rasterizer that ships with ImGui, compiled privately into this file
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "imstb_truetype.h"
+
+#include "cppgfx/robotofont.hpp"
+
+namespace cppgfx {
+
+using software::blendPixel;
+using software::blendSpan;
+using software::div255;
+using software::pack;
+
+struct SoftwareRenderer::FontInfo {
+    stbtt_fontinfo info;
+    std::unordered_map<uint64_t, Glyph> glyphs;
+};
+
+// Accumulate the signed area that a line covers in each pixel, relative to the pixels left of it.
+// The running sum over a row then gives the exact coverage of every pixel (see font-rs by Raph Levien).
+// The line must be within 0 <= x <= width, rows outside of the accumulation buffer are skipped.
+static void accumulateSegment(sf::Vector2f p0, sf::Vector2f p1, float width, float* accumulation, size_t stride,
+                              int rows)
+{
+    if (p0.y == p1.y) {
+        return;
+    }
+
+    float direction = 1.f;
+    if (p0.y > p1.y) {
+        std::swap(p0, p1);
+        direction = -1.f;
+    }
+
+    float dxdy = (p1.x - p0.x) / (p1.y - p0.y);
+    int yStart = std::max(0, static_cast<int>(std::floor(p0.y)));
+    int yEnd = std::min(rows, static_cast<int>(std::ceil(p1.y)));
+    float x = std::clamp(p0.x + dxdy * (std::max(p0.y, static_cast<float>(yStart)) - p0.y), 0.f, width);
+
+    for (int y = yStart; y < yEnd; y++) {
+        float* row = accumulation + static_cast<size_t>(y) * stride;
+        float dy = std::min(static_cast<float>(y + 1), p1.y) - std::max(static_cast<float>(y), p0.y);
+        float xNext = std::clamp(x + dxdy * dy, 0.f, width);
+        float d = dy * direction;
+
+        float x0 = std::min(x, xNext);
+        float x1 = std::max(x, xNext);
+        float x0Floor = std::floor(x0);
+        float x1Ceil = std::ceil(x1);
+        int x0i = static_cast<int>(x0Floor);
+        int x1i = static_cast<int>(x1Ceil);
+
+        if (x1i <= x0i + 1) {
+            // The line stays within one pixel in this row
+            float xmf = 0.5f * (x + xNext) - x0Floor;
+            row[x0i] += d - d * xmf;
+            row[x0i + 1] += d * xmf;
+        }
+        else {
+            float s = 1.f / (x1 - x0);
+            float x0f = x0 - x0Floor;
+            float a0 = 0.5f * s * (1.f - x0f) * (1.f - x0f);
+            float x1f = x1 - x1Ceil + 1.f;
+            float am = 0.5f * s * x1f * x1f;
+            row[x0i] += d * a0;
+            if (x1i == x0i + 2) {
+                row[x0i + 1] += d * (1.f - a0 - am);
+            }
+            else {
+                float a1 = s * (1.5f - x0f);
+                row[x0i + 1] += d * (a1 - a0);
+                for (int xi = x0i + 2; xi < x1i - 1; xi++) {
+                    row[xi] += d * s;
+                }
+                float a2 = a1 + static_cast<float>(x1i - x0i - 3) * s;
+                row[x1i - 1] += d * (1.f - a2 - am);
+            }
+            row[x1i] += d * am;
+        }
+
+        x = xNext;
+    }
+}
+
+SoftwareRenderer::SoftwareRenderer(uint32_t width, uint32_t height)
+{
+    // The fallback font is loaded right away, so that a broken build fails early
+    font(TextStyle());
+    resize(width, height);
+}
+
+SoftwareRenderer::~SoftwareRenderer() = default;
+
+void SoftwareRenderer::resize(uint32_t width, uint32_t height)
+{
+    m_width = width;
+    m_height = height;
+    m_pixels.assign(static_cast<size_t>(width) * height, 0);
+}
+
+const uint8_t* SoftwareRenderer::getPixels() const
+{
+    return reinterpret_cast<const uint8_t*>(m_pixels.data());
+}
+
+sf::Image SoftwareRenderer::toImage() const
+{
+    sf::Image image;
+    image.create(m_width, m_height, getPixels());
+    return image;
+}
+
+void SoftwareRenderer::clear(const sf::Color& color)
+{
+    std::fill(m_pixels.begin(), m_pixels.end(), pack(color));
+}
+
+void SoftwareRenderer::discard()
+{
+    // Primitives are drawn immediately, nothing is pending
+}
+
+void SoftwareRenderer::flush()
+{
+    // Primitives are drawn immediately, nothing is pending
+}
+
+void SoftwareRenderer::convex(const sf::Vector2f* points, size_t count, const sf::Color& color)
+{
+    if (count < 3 || color.a == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        addEdge(points[i], points[(i + 1 == count) ? 0 : i + 1]);
+    }
+    m_stats->vertices += count;
+    m_stats->triangles += count - 2;
+    fillPath(color);
+}
+
+void SoftwareRenderer::strip(const sf::Vector2f* points, size_t count, const sf::Color& color)
+{
+    if (count < 3 || color.a == 0) {
+        return;
+    }
+
+    // All triangles are filled together, so that there are no seams between them
+    for (size_t i = 2; i < count; i++) {
+        addTriangle(points[i - 2], points[i - 1], points[i]);
+    }
+    m_stats->vertices += count;
+    m_stats->triangles += count - 2;
+    fillPath(color);
+}
+
+void SoftwareRenderer::ring(const sf::Vector2f* outer,
+                            const sf::Vector2f* inner,
+                            size_t count,
+                            const sf::Color& color)
+{
+    if (count < 2 || color.a == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        size_t next = (i + 1 == count) ? 0 : i + 1;
+        addTriangle(inner[i], outer[i], inner[next]);
+        addTriangle(inner[next], outer[i], outer[next]);
+    }
+    m_stats->vertices += count * 2;
+    m_stats->triangles += count * 2;
+    fillPath(color);
+}
+
+void SoftwareRenderer::text(const std::string& text,
+                            const sf::Vector2f& position,
+                            float align,
+                            const TextStyle& style)
+{
+    sf::FloatRect bounds = layout(font(style), text, style.characterSize, style.outlineThickness);
+    if (m_placedGlyphs.empty()) {
+        return;
+    }
+
+    // The text is positioned by the top of its bounds, not by its baseline
+    sf::Vector2f origin = { position.x - bounds.width * align, position.y - bounds.top };
+
+    if (style.outlineThickness != 0 && style.outlineColor.a != 0) {
+        for (const auto& placed : m_placedGlyphs) {
+            blitGlyph(*placed.outline, origin + placed.position, style.outlineColor);
+        }
+        m_stats->triangles += m_placedGlyphs.size() * 2;
+    }
+    if (style.fillColor.a != 0) {
+        for (const auto& placed : m_placedGlyphs) {
+            blitGlyph(*placed.glyph, origin + placed.position, style.fillColor);
+        }
+        m_stats->triangles += m_placedGlyphs.size() * 2;
+    }
+    m_stats->drawCalls++;
+}
+
+void SoftwareRenderer::textWidths(const std::string* texts, size_t count, const TextStyle& style, float* widths)
+{
+    FontInfo& info = font(style);
+    for (size_t i = 0; i < count; i++) {
+        widths[i] = layout(info, texts[i], style.characterSize, 0).width;
+    }
+}
+
+void SoftwareRenderer::addEdge(const sf::Vector2f& from, const sf::Vector2f& to)
+{
+    countGrowth(m_edges, m_edges.size() + 1, *m_stats);
+    m_edges.push_back({ from, to });
+}
+
+void SoftwareRenderer::addTriangle(const sf::Vector2f& a, const sf::Vector2f& b, const sf::Vector2f& c)
+{
+    // All triangles of a path get the same winding, so that overlapping triangles add up instead of cancelling
+    float cross = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (cross > 0) {
+        addEdge(a, b);
+        addEdge(b, c);
+        addEdge(c, a);
+    }
+    else if (cross < 0) {
+        addEdge(a, c);
+        addEdge(c, b);
+        addEdge(b, a);
+    }
+}
+
+void SoftwareRenderer::fillPath(const sf::Color& color)
+{
+    if (m_edges.empty()) {
+        return;
+    }
+
+    float minX = m_edges.front().from.x;
+    float minY = m_edges.front().from.y;
+    float maxX = minX;
+    float maxY = minY;
+    for (const auto& edge : m_edges) {
+        minX = std::min({ minX, edge.from.x, edge.to.x });
+        minY = std::min({ minY, edge.from.y, edge.to.y });
+        maxX = std::max({ maxX, edge.from.x, edge.to.x });
+        maxY = std::max({ maxY, edge.from.y, edge.to.y });
+    }
+
+    // The pixels that the path touches, clipped to the image
+    float imageWidth = static_cast<float>(m_width);
+    float imageHeight = static_cast<float>(m_height);
+    int left = static_cast<int>(std::clamp(std::floor(minX), 0.f, imageWidth));
+    int top = static_cast<int>(std::clamp(std::floor(minY), 0.f, imageHeight));
+    int right = static_cast<int>(std::clamp(std::ceil(maxX), 0.f, imageWidth));
+    int bottom = static_cast<int>(std::clamp(std::ceil(maxY), 0.f, imageHeight));
+    if (!(left < right && top < bottom)) {
+        m_edges.clear();
+        return;
+    }
+
+    size_t columns = static_cast<size_t>(right - left);
+    int rows = bottom - top;
+    size_t stride = columns + 2;
+    float width = static_cast<float>(columns);
+    countGrowth(m_accumulation, stride * static_cast<size_t>(rows), *m_stats);
+    m_accumulation.assign(stride * static_cast<size_t>(rows), 0.f);
+
+    sf::Vector2f origin = { static_cast<float>(left), static_cast<float>(top) };
+    for (const auto& edge : m_edges) {
+        sf::Vector2f from = edge.from - origin;
+        sf::Vector2f to = edge.to - origin;
+
+        // Parts of the edge left of the path bounds are moved onto the left border, and parts right of it onto
+        // the right border. The coverage of a pixel only depends on the edges left of it, so this does not
+        // change the result within the bounds.
+        float splits[4] = { 0.f, 1.f };
+        size_t splitCount = 2;
+        if ((from.x < 0) != (to.x < 0)) {
+            splits[splitCount++] = (0 - from.x) / (to.x - from.x);
+        }
+        if ((from.x > width) != (to.x > width)) {
+            splits[splitCount++] = (width - from.x) / (to.x - from.x);
+        }
+        std::sort(splits, splits + splitCount);
+
+        sf::Vector2f start = from;
+        for (size_t i = 1; i < splitCount; i++) {
+            sf::Vector2f end = (i + 1 == splitCount) ? to : from + (to - from) * splits[i];
+            sf::Vector2f a = { std::clamp(start.x, 0.f, width), start.y };
+            sf::Vector2f b = { std::clamp(end.x, 0.f, width), end.y };
+            accumulateSegment(a, b, width, m_accumulation.data(), stride, rows);
+            start = end;
+        }
+    }
+
+    // Resolve the coverage scanline by scanline and blend it into the image
+    countGrowth(m_coverage, columns, *m_stats);
+    m_coverage.resize(columns);
+    for (int y = 0; y < rows; y++) {
+        const float* accumulation = m_accumulation.data() + static_cast<size_t>(y) * stride;
+        float sum = 0.f;
+        for (size_t x = 0; x < columns; x++) {
+            sum += accumulation[x];
+            m_coverage[x] = static_cast<uint8_t>(std::min(1.f, std::abs(sum)) * 255.f + 0.5f);
+        }
+        uint32_t* pixels = m_pixels.data() + static_cast<size_t>(top + y) * m_width + left;
+        blendRow(pixels, m_coverage.data(), columns, color);
+    }
+
+    m_stats->drawCalls++;
+    m_edges.clear();
+}
+
+void SoftwareRenderer::blendRow(uint32_t* pixels, const uint8_t* coverage, size_t count, const sf::Color& color)
+{
+    size_t x = 0;
+    while (x < count) {
+        uint8_t c = coverage[x];
+        if (c == 0) {
+            x++;
+        }
+        else if (c == 255) {
+            // Fully covered pixels come in long runs in the inside of shapes
+            size_t end = x + 1;
+            while (end < count && coverage[end] == 255) {
+                end++;
+            }
+            blendSpan(pixels + x, end - x, color, color.a);
+            x = end;
+        }
+        else {
+            blendPixel(pixels[x], color, div255(color.a * c));
+            x++;
+        }
+    }
+}
+
+void SoftwareRenderer::blitGlyph(const Glyph& glyph, const sf::Vector2f& position, const sf::Color& color)
+{
+    float x = std::round(position.x) + static_cast<float>(glyph.left);
+    float y = std::round(position.y) + static_cast<float>(glyph.top);
+    float imageWidth = static_cast<float>(m_width);
+    float imageHeight = static_cast<float>(m_height);
+    if (glyph.width == 0 || glyph.height == 0 || !(x < imageWidth && y < imageHeight)
+        || !(x + static_cast<float>(glyph.width) > 0 && y + static_cast<float>(glyph.height) > 0)) {
+        return;
+    }
+
+    int glyphX = static_cast<int>(x);
+    int glyphY = static_cast<int>(y);
+    int left = std::max(glyphX, 0);
+    int top = std::max(glyphY, 0);
+    int right = std::min(glyphX + glyph.width, static_cast<int>(m_width));
+    int bottom = std::min(glyphY + glyph.height, static_cast<int>(m_height));
+
+    for (int row = top; row < bottom; row++) {
+        const uint8_t* coverage = glyph.coverage.data() + (row - glyphY) * glyph.width + (left - glyphX);
+        uint32_t* pixels = m_pixels.data() + static_cast<size_t>(row) * m_width + left;
+        blendRow(pixels, coverage, static_cast<size_t>(right - left), color);
+    }
+}
+
+// This follows sf::Text::ensureGeometryUpdate() for the regular text style, like the TextCache does,
+// but with the glyph metrics of the software renderer.
+SoftwareRenderer::FontInfo& SoftwareRenderer::font(const TextStyle& style)
+{
+    const uint8_t* data = style.fontData ? style.fontData : ROBOTO_MEDIUM_DATA;
+    auto found = m_fonts.find(data);
+    if (found != m_fonts.end()) {
+        return *found->second;
+    }
+
+    auto info = std::make_unique<FontInfo>();
+    int offset = stbtt_GetFontOffsetForIndex(data, 0);
+    if (offset < 0 || !stbtt_InitFont(&info->info, data, offset)) {
+        throw std::runtime_error("[cppgfx]: The software renderer failed to load a font");
+    }
+    m_stats->allocations++;
+    return *m_fonts.emplace(data, std::move(info)).first->second;
+}
+
+sf::FloatRect SoftwareRenderer::layout(FontInfo& font,
+                                       const std::string& text,
+                                       uint32_t characterSize,
+                                       float outlineThickness)
+{
+    m_placedGlyphs.clear();
+
+    sf::String string(text);
+    if (string.isEmpty()) {
+        return sf::FloatRect();
+    }
+
+    int ascent = 0;
+    int descent = 0;
+    int lineGap = 0;
+    stbtt_GetFontVMetrics(&font.info, &ascent, &descent, &lineGap);
+    float scale = stbtt_ScaleForMappingEmToPixels(&font.info, static_cast<float>(characterSize));
+    float lineSpacing = std::round(static_cast<float>(ascent - descent + lineGap) * scale);
+
+    float whitespaceWidth = glyph(font, U' ', characterSize, 0).advance;
+    float x = 0.f;
+    float y = static_cast<float>(characterSize);
+
+    float minX = static_cast<float>(characterSize);
+    float minY = static_cast<float>(characterSize);
+    float maxX = 0.f;
+    float maxY = 0.f;
+    uint32_t prevChar = 0;
+
+    for (size_t i = 0; i < string.getSize(); i++) {
+        uint32_t curChar = string[i];
+
+        // Skip the \r char like sf::Text does
+        if (curChar == U'\r') {
+            continue;
+        }
+
+        x += kerning(font, prevChar, curChar, characterSize);
+        prevChar = curChar;
+
+        if (curChar == U' ' || curChar == U'\n' || curChar == U'\t') {
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+
+            switch (curChar) {
+            case U' ':
+                x += whitespaceWidth;
+                break;
+            case U'\t':
+                x += whitespaceWidth * 4;
+                break;
+            case U'\n':
+                y += lineSpacing;
+                x = 0;
+                break;
+            }
+
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+            continue;
+        }
+
+        const Glyph& fill = glyph(font, curChar, characterSize, 0);
+        const Glyph* outline
+            = (outlineThickness != 0) ? &glyph(font, curChar, characterSize, outlineThickness) : nullptr;
+        countGrowth(m_placedGlyphs, m_placedGlyphs.size() + 1, *m_stats);
+        m_placedGlyphs.push_back({ &fill, outline, { x, y } });
+
+        minX = std::min(minX, x + static_cast<float>(fill.left));
+        maxX = std::max(maxX, x + static_cast<float>(fill.left + fill.width));
+        minY = std::min(minY, y + static_cast<float>(fill.top));
+        maxY = std::max(maxY, y + static_cast<float>(fill.top + fill.height));
+
+        x += fill.advance;
+    }
+
+    if (outlineThickness != 0) {
+        float outline = std::abs(std::ceil(outlineThickness));
+        minX -= outline;
+        maxX += outline;
+        minY -= outline;
+        maxY += outline;
+    }
+
+    m_stats->glyphsLaidOut += m_placedGlyphs.size();
+    return sf::FloatRect(minX, minY, maxX - minX, maxY - minY);
+}
+
+const SoftwareRenderer::Glyph& SoftwareRenderer::glyph(FontInfo& font,
+                                                       uint32_t codepoint,
+                                                       uint32_t characterSize,
+                                                       float outlineThickness)
+{
+    float radius = std::round(std::abs(outlineThickness) * 16) / 16;
+    uint64_t key = static_cast<uint64_t>(codepoint) | (static_cast<uint64_t>(characterSize) << 21)
+        | (static_cast<uint64_t>(std::lround(radius * 16)) << 42);
+    auto found = font.glyphs.find(key);
+    if (found != font.glyphs.end()) {
+        return found->second;
+    }
+
+    const stbtt_fontinfo& info = font.info;
+    float scale = stbtt_ScaleForMappingEmToPixels(&info, static_cast<float>(characterSize));
+    int codepointIndex = static_cast<int>(codepoint);
+
+    Glyph& entry = font.glyphs[key];
+    m_stats->allocations++;
+    int advance = 0;
+    int leftSideBearing = 0;
+    stbtt_GetCodepointHMetrics(&info, codepointIndex, &advance, &leftSideBearing);
+    entry.advance = std::round(static_cast<float>(advance) * scale);
+
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = 0;
+    int y1 = 0;
+    stbtt_GetCodepointBitmapBox(&info, codepointIndex, scale, scale, &x0, &y0, &x1, &y1);
+    int width = x1 - x0;
+    int height = y1 - y0;
+    if (width <= 0 || height <= 0) {
+        return entry;
+    }
+
+    std::vector<uint8_t> coverage(static_cast<size_t>(width * height));
+    m_stats->allocations++;
+    stbtt_MakeCodepointBitmap(&info, coverage.data(), width, height, width, scale, scale, codepointIndex);
+
+    if (radius == 0) {
+        entry.left = x0;
+        entry.top = y0;
+        entry.width = width;
+        entry.height = height;
+        entry.coverage = std::move(coverage);
+        return entry;
+    }
+
+    // The outline is the glyph grown by the outline thickness in every direction
+    int grow = static_cast<int>(std::ceil(radius));
+    entry.left = x0 - grow;
+    entry.top = y0 - grow;
+    entry.width = width + grow * 2;
+    entry.height = height + grow * 2;
+    entry.coverage.assign(static_cast<size_t>(entry.width * entry.height), 0);
+    m_stats->allocations++;
+    for (int dy = -grow; dy <= grow; dy++) {
+        for (int dx = -grow; dx <= grow; dx++) {
+            if (static_cast<float>(dx * dx + dy * dy) > radius * radius) {
+                continue;
+            }
+            for (int y = 0; y < height; y++) {
+                const uint8_t* source = coverage.data() + y * width;
+                uint8_t* destination = entry.coverage.data() + (y + grow + dy) * entry.width + grow + dx;
+                for (int x = 0; x < width; x++) {
+                    destination[x] = std::max(destination[x], source[x]);
+                }
+            }
+        }
+    }
+    return entry;
+}
+
+float SoftwareRenderer::kerning(const FontInfo& font, uint32_t first, uint32_t second, uint32_t characterSize)
+{
+    if (first == 0 || second == 0) {
+        return 0.f;
+    }
+    float scale = stbtt_ScaleForMappingEmToPixels(&font.info, static_cast<float>(characterSize));
+    int kerning = stbtt_GetCodepointKernAdvance(&font.info, static_cast<int>(first), static_cast<int>(second));
+    return std::round(static_cast<float>(kerning) * scale);
+}
+
+} // namespace cppgfx
@@ -0,0 +1,224 @@
+
+#include "cppgfx/textcache.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cppgfx {
+
+// FNV-1a over the string and the parameters that influence the layout
+static uint64_t hashKey(const std::string& text, uint32_t fontId, uint32_t characterSize, float outlineThickness)
+{
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        auto bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+    mix(text.data(), text.size());
+    mix(&fontId, sizeof(fontId));
+    mix(&characterSize, sizeof(characterSize));
+    mix(&outlineThickness, sizeof(outlineThickness));
+    return hash;
+}
+
+// Same quad as sf::Text generates for a glyph, without color
+static void addGlyphQuad(std::vector<sf::Vertex>& vertices, const sf::Vector2f& position, const sf::Glyph& glyph)
+{
+    float padding = 1.0f;
+
+    float left = glyph.bounds.left - padding;
+    float top = glyph.bounds.top - padding;
+    float right = glyph.bounds.left + glyph.bounds.width + padding;
+    float bottom = glyph.bounds.top + glyph.bounds.height + padding;
+
+    float u1 = static_cast<float>(glyph.textureRect.left) - padding;
+    float v1 = static_cast<float>(glyph.textureRect.top) - padding;
+    float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+    float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+
+    sf::Color color = sf::Color::White;
+    vertices.push_back(sf::Vertex({ position.x + left, position.y + top }, color, { u1, v1 }));
+    vertices.push_back(sf::Vertex({ position.x + right, position.y + top }, color, { u2, v1 }));
+    vertices.push_back(sf::Vertex({ position.x + left, position.y + bottom }, color, { u1, v2 }));
+    vertices.push_back(sf::Vertex({ position.x + left, position.y + bottom }, color, { u1, v2 }));
+    vertices.push_back(sf::Vertex({ position.x + right, position.y + top }, color, { u2, v1 }));
+    vertices.push_back(sf::Vertex({ position.x + right, position.y + bottom }, color, { u2, v2 }));
+}
+
+TextCache::TextCache(size_t capacity)
+    : m_capacity(std::max<size_t>(capacity, 1))
+{
+}
+
+const TextLayout& TextCache::get(const std::string& text,
+                                 const sf::Font& font,
+                                 uint32_t fontId,
+                                 uint32_t characterSize,
+                                 float outlineThickness,
+                                 FrameStats& stats)
+{
+    uint64_t hash = hashKey(text, fontId, characterSize, outlineThickness);
+
+    auto found = m_index.find(hash);
+    if (found != m_index.end()) {
+        auto entry = found->second;
+        if (entry->fontId == fontId && entry->characterSize == characterSize
+            && entry->outlineThickness == outlineThickness && entry->text == text) {
+            m_entries.splice(m_entries.begin(), m_entries, entry);
+            return entry->layout;
+        }
+
+        // Hash collision: The new string replaces the old one
+        m_entries.erase(entry);
+        m_index.erase(found);
+    }
+
+    // Reuse the least recently used entry when the cache is full, including its memory
+    if (m_entries.size() >= m_capacity) {
+        m_index.erase(m_entries.back().hash);
+        m_entries.splice(m_entries.begin(), m_entries, std::prev(m_entries.end()));
+    }
+    else {
+        m_entries.emplace_front();
+        stats.allocations++;
+    }
+
+    Entry& entry = m_entries.front();
+    if (text.size() > entry.text.capacity()) {
+        stats.allocations++;
+    }
+    entry.text = text;
+    entry.fontId = fontId;
+    entry.characterSize = characterSize;
+    entry.outlineThickness = outlineThickness;
+    entry.hash = hash;
+    build(entry.layout, text, font, characterSize, outlineThickness, stats);
+    m_index[hash] = m_entries.begin();
+    return entry.layout;
+}
+
+void TextCache::forget(uint32_t fontId)
+{
+    for (auto entry = m_entries.begin(); entry != m_entries.end();) {
+        if (entry->fontId == fontId) {
+            m_index.erase(entry->hash);
+            entry = m_entries.erase(entry);
+        }
+        else {
+            ++entry;
+        }
+    }
+}
+
+// This follows sf::Text::ensureGeometryUpdate() for the regular text style, so that the
+// geometry and bounds are exactly the same as when drawing an sf::Text.
+void TextCache::build(TextLayout& layout,
+                      const std::string& text,
+                       const sf::Font& font,
+                       uint32_t characterSize,
+                       float outlineThickness,
+                       FrameStats& stats)
+{
+    size_t vertexCapacity = layout.vertices.capacity();
+    size_t fillCapacity = m_fillVertices.capacity();
+    layout.vertices.clear();
+    layout.outlineVertexCount = 0;
+    layout.bounds = sf::FloatRect();
+
+    sf::String string(text);
+    if (string.isEmpty()) {
+        return;
+    }
+
+    float whitespaceWidth = font.getGlyph(U' ', characterSize, false).advance;
+    float lineSpacing = font.getLineSpacing(characterSize);
+    float x = 0.f;
+    float y = static_cast<float>(characterSize);
+
+    float minX = static_cast<float>(characterSize);
+    float minY = static_cast<float>(characterSize);
+    float maxX = 0.f;
+    float maxY = 0.f;
+    uint32_t prevChar = 0;
+
+    // The fill quads are collected separately, since they are drawn after the outline
+    m_fillVertices.clear();
+
+    for (size_t i = 0; i < string.getSize(); i++) {
+        uint32_t curChar = string[i];
+
+        // Skip the \r char to avoid weird graphical issues
+        if (curChar == U'\r') {
+            continue;
+        }
+
+        x += font.getKerning(prevChar, curChar, characterSize);
+        prevChar = curChar;
+
+        if (curChar == U' ' || curChar == U'\n' || curChar == U'\t') {
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+
+            switch (curChar) {
+            case U' ':
+                x += whitespaceWidth;
+                break;
+            case U'\t':
+                x += whitespaceWidth * 4;
+                break;
+            case U'\n':
+                y += lineSpacing;
+                x = 0;
+                break;
+            }
+
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+            continue;
+        }
+
+        if (outlineThickness != 0) {
+            const sf::Glyph& glyph = font.getGlyph(curChar, characterSize, false, outlineThickness);
+            addGlyphQuad(layout.vertices, { x, y }, glyph);
+        }
+
+        const sf::Glyph& glyph = font.getGlyph(curChar, characterSize, false);
+        addGlyphQuad(m_fillVertices, { x, y }, glyph);
+
+        float left = glyph.bounds.left;
+        float top = glyph.bounds.top;
+        float right = glyph.bounds.left + glyph.bounds.width;
+        float bottom = glyph.bounds.top + glyph.bounds.height;
+
+        minX = std::min(minX, x + left);
+        maxX = std::max(maxX, x + right);
+        minY = std::min(minY, y + top);
+        maxY = std::max(maxY, y + bottom);
+
+        x += glyph.advance;
+    }
+
+    if (outlineThickness != 0) {
+        float outline = std::abs(std::ceil(outlineThickness));
+        minX -= outline;
+        maxX += outline;
+        minY -= outline;
+        maxY += outline;
+    }
+
+    stats.glyphsLaidOut += m_fillVertices.size() / 6;
+    layout.outlineVertexCount = layout.vertices.size();
+    layout.vertices.insert(layout.vertices.end(), m_fillVertices.begin(), m_fillVertices.end());
+    layout.bounds = sf::FloatRect(minX, minY, maxX - minX, maxY - minY);
+
+    if (layout.vertices.capacity() != vertexCapacity) {
+        stats.allocations++;
+    }
+    if (m_fillVertices.capacity() != fillCapacity) {
+        stats.allocations++;
+    }
+}
+
+} // namespace cppgfx
@@ -0,0 +1,149 @@
+
+#include "cppgfx/textmetrics.hpp"
+
+#include <algorithm>
+
+namespace cppgfx {
+
+static bool isAscii(const std::string& text)
+{
+    uint8_t combined = 0;
+    for (char c : text) {
+        combined |= static_cast<uint8_t>(c);
+    }
+    return combined < 0x80;
+}
+
+float TextMetrics::width(const std::string& text, const sf::Font& font, uint32_t fontId, uint32_t characterSize)
+{
+    float result = 0.f;
+    widths(&text, 1, font, fontId, characterSize, &result);
+    return result;
+}
+
+void TextMetrics::widths(const std::string* texts,
+                         size_t count,
+                         const sf::Font& font,
+                         uint32_t fontId,
+                         uint32_t characterSize,
+                         float* widths)
+{
+    Table& metrics = table(font, fontId, characterSize);
+    for (size_t i = 0; i < count; i++) {
+        const std::string& text = texts[i];
+        if (isAscii(text)) {
+            auto chars = reinterpret_cast<const uint8_t*>(text.data());
+            widths[i] = measure(chars, text.size(), metrics, font, characterSize);
+        }
+        else {
+            sf::String string(text);
+            widths[i] = measure(string.getData(), string.getSize(), metrics, font, characterSize);
+        }
+    }
+}
+
+void TextMetrics::forget(uint32_t fontId)
+{
+    for (auto table = m_tables.begin(); table != m_tables.end();) {
+        if (table->first >> 32 == fontId) {
+            table = m_tables.erase(table);
+        }
+        else {
+            ++table;
+        }
+    }
+}
+
+TextMetrics::Table& TextMetrics::table(const sf::Font& font, uint32_t fontId, uint32_t characterSize)
+{
+    uint64_t key = (static_cast<uint64_t>(fontId) << 32) | characterSize;
+    auto found = m_tables.find(key);
+    if (found != m_tables.end()) {
+        return found->second;
+    }
+
+    Table& table = m_tables[key];
+    float whitespaceWidth = font.getGlyph(U' ', characterSize, false).advance;
+    for (uint32_t c = 0; c < ASCII_COUNT; c++) {
+        switch (c) {
+        case U' ':
+            table.advance[c] = whitespaceWidth;
+            table.right[c] = whitespaceWidth;
+            break;
+        case U'\t':
+            table.advance[c] = whitespaceWidth * 4;
+            table.right[c] = whitespaceWidth * 4;
+            break;
+        case U'\n':
+        case U'\r':
+            break;
+        default:
+            const sf::Glyph& glyph = font.getGlyph(c, characterSize, false);
+            table.advance[c] = glyph.advance;
+            table.left[c] = glyph.bounds.left;
+            table.right[c] = glyph.bounds.left + glyph.bounds.width;
+            break;
+        }
+    }
+    table.kerning.assign(ASCII_COUNT * ASCII_COUNT, std::nullopt);
+    return table;
+}
+
+// This follows the horizontal part of sf::Text::ensureGeometryUpdate() for the regular text style
+// without outline, so that the result is exactly the width of the local bounds of an sf::Text.
+// SFML's glyph metrics are multiples of 1/64 pixel, which keeps every addition below exact.
+template<typename Char>
+float TextMetrics::measure(const Char* chars, size_t count, Table& table, const sf::Font& font, uint32_t characterSize)
+{
+    if (count == 0) {
+        return 0.f;
+    }
+
+    float x = 0.f;
+    float minX = static_cast<float>(characterSize);
+    float maxX = 0.f;
+    uint32_t prevChar = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t curChar = chars[i];
+
+        // Skip the \r char like sf::Text does
+        if (curChar == U'\r') {
+            continue;
+        }
+
+        if (prevChar < ASCII_COUNT && curChar < ASCII_COUNT) {
+            std::optional<float>& kerning = table.kerning[prevChar * ASCII_COUNT + curChar];
+            if (!kerning) {
+                kerning = font.getKerning(prevChar, curChar, characterSize);
+            }
+            x += *kerning;
+        }
+        else {
+            x += font.getKerning(prevChar, curChar, characterSize);
+        }
+        prevChar = curChar;
+
+        if (curChar == U'\n') {
+            minX = std::min(minX, x);
+            x = 0.f;
+            continue;
+        }
+
+        if (curChar < ASCII_COUNT) {
+            minX = std::min(minX, x + table.left[curChar]);
+            maxX = std::max(maxX, x + table.right[curChar]);
+            x += table.advance[curChar];
+        }
+        else {
+            const sf::Glyph& glyph = font.getGlyph(curChar, characterSize, false);
+            minX = std::min(minX, x + glyph.bounds.left);
+            maxX = std::max(maxX, x + glyph.bounds.left + glyph.bounds.width);
+            x += glyph.advance;
+        }
+    }
+
+    return maxX - minX;
+}
+
+} // namespace cppgfx
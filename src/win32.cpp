@@ -22,6 +22,11 @@ void Win32EnableDarkTitleBar(sf::WindowHandle handle, bool darkTitleBar)
     }
 #endif
 }
+
+bool Win32IsMinimized(sf::WindowHandle handle)
+{
+    return IsIconic(handle) != 0;
+}
 }
 
 #endif // _WIN32
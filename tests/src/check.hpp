@@ -0,0 +1,46 @@
+#ifndef CPPGFX_TESTS_CHECK_HPP
+#define CPPGFX_TESTS_CHECK_HPP
+
+#include "spdlog/fmt/fmt.h"
+#include <cstdlib>
+
+// A minimal check macro for the tests, which are plain executables run by CTest. A failed check is
+// reported and the test continues, the exit code of main() tells CTest if any check failed.
+
+inline int& checkFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            fmt::print(stderr, "{}:{}: CHECK({}) failed\n", __FILE__, __LINE__, #condition); \
+            checkFailures()++;                                                            \
+        }                                                                                 \
+    } while (false)
+
+// The exit code that CTest treats as a skipped test, see SKIP_RETURN_CODE in tests/CMakeLists.txt
+constexpr int SKIP_TEST = 77;
+
+// SFML needs a display for OpenGL contexts on X11, which fonts use for their glyph textures
+inline bool hasDisplay()
+{
+#if defined(__linux__) || defined(__FreeBSD__)
+    return std::getenv("DISPLAY") != nullptr || std::getenv("WAYLAND_DISPLAY") != nullptr;
+#else
+    return true;
+#endif
+}
+
+inline int checkResult()
+{
+    if (checkFailures() > 0) {
+        fmt::print(stderr, "{} check(s) failed\n", checkFailures());
+        return 1;
+    }
+    return 0;
+}
+
+#endif //CPPGFX_TESTS_CHECK_HPP
@@ -0,0 +1,53 @@
+#include "check.hpp"
+#include "cppgfx/cppgfx.hpp"
+
+#include <cstdlib>
+
+class HeadlessApp : public cppgfx::App {
+public:
+    float setupTextWidth = 0;
+    uint64_t frames = 0;
+    bool drawn = true;
+
+    void setup() override
+    {
+        size(64, 32);
+        setTitle("Headless");
+        setFrameRate(30);
+        setVerticalSync(false);
+        setupTextWidth = textWidth("Hello");
+    }
+
+    void update() override
+    {
+        background(0);
+        noStroke();
+        fill(255, 0, 0);
+        rect(8, 8, 16, 16);
+        text("Hi", 32, 4);
+    }
+};
+
+// runHeadless() must not need a display, so it is tested without one
+int main()
+{
+#if defined(__linux__) || defined(__FreeBSD__)
+    unsetenv("DISPLAY");
+    unsetenv("WAYLAND_DISPLAY");
+#endif
+
+    HeadlessApp app;
+    app.runHeadless(3, 1.0f / 60.0f, [&app](const cppgfx::SoftwareRenderer& renderer) {
+        app.frames++;
+        const uint8_t* pixels = renderer.getPixels();
+        auto red = [&](uint32_t x, uint32_t y) { return pixels[(y * renderer.getWidth() + x) * 4]; };
+        app.drawn = app.drawn && renderer.getWidth() == 64 && renderer.getHeight() == 32
+                 && red(12, 12) == 255 && red(2, 2) == 0;
+    });
+
+    CHECK(app.frames == 3);
+    CHECK(app.frameCount == 3);
+    CHECK(app.drawn);
+    CHECK(app.setupTextWidth > 0);
+    return checkResult();
+}
@@ -0,0 +1,147 @@
+#include "check.hpp"
+#include "cppgfx/jobsystem.hpp"
+
+#include <chrono>
+#include <ctime>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+// Jobs from outside of the pool run in the order they were submitted
+static void testSubmissionOrder()
+{
+    cppgfx::JobSystem jobs(1);
+    cppgfx::JobGroup group;
+    std::atomic<bool> release { false };
+    std::vector<int> order;
+
+    jobs.submit([&release] {
+        while (!release) {
+            std::this_thread::yield();
+        }
+    }, &group);
+    for (int i = 0; i < 10; i++) {
+        jobs.submit([&order, i] { order.push_back(i); }, &group);
+    }
+    release = true;
+
+    // Only the worker runs jobs, since this thread does not wait in the pool
+    while (!group.isDone()) {
+        std::this_thread::sleep_for(1ms);
+    }
+    std::vector<int> expected(10);
+    std::iota(expected.begin(), expected.end(), 0);
+    CHECK(order == expected);
+}
+
+// Like std::future, a task releases its job in get() and refuses to get a result without one
+static void testTaskWithoutJob()
+{
+    cppgfx::JobSystem jobs(1);
+    auto task = jobs.submit([] { return 7; });
+    CHECK(task.valid());
+    CHECK(task.get() == 7);
+    CHECK(!task.valid());
+
+    auto throws = [](auto& task) {
+        try {
+            task.get();
+        }
+        catch (const std::logic_error&) {
+            return true;
+        }
+        return false;
+    };
+    CHECK(throws(task));
+    cppgfx::Task<void> empty;
+    CHECK(throws(empty));
+}
+
+// Waiting for a group does not wait for the other jobs of the pool
+static void testGroups()
+{
+    cppgfx::JobSystem jobs(2);
+    cppgfx::JobGroup fast;
+    cppgfx::JobGroup slow;
+    std::atomic<bool> started { false };
+    std::atomic<bool> release { false };
+
+    // The slow job must run on a worker, this thread would wait for itself otherwise
+    jobs.submit([&started, &release] {
+        started = true;
+        while (!release) {
+            std::this_thread::sleep_for(1ms);
+        }
+    }, &slow);
+    while (!started) {
+        std::this_thread::yield();
+    }
+    auto task = jobs.submit([] { return 42; }, &fast);
+    jobs.wait(fast);
+    CHECK(fast.isDone());
+    CHECK(!slow.isDone());
+    CHECK(task.get() == 42);
+
+    release = true;
+    jobs.wait(slow);
+    CHECK(slow.isDone());
+}
+
+static void testParallelFor()
+{
+    cppgfx::JobSystem jobs(3);
+    std::vector<int> values(10000, 0);
+    jobs.parallelFor(0, values.size(), 0, [&values](size_t i) { values[i] = static_cast<int>(i); });
+    bool correct = true;
+    for (size_t i = 0; i < values.size(); i++) {
+        correct = correct && values[i] == static_cast<int>(i);
+    }
+    CHECK(correct);
+
+    bool thrown = false;
+    try {
+        jobs.parallelFor(0, 100, 1, [](size_t i) {
+            if (i == 50) {
+                throw std::runtime_error("fail");
+            }
+        });
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+// A thread that waits for a long job sleeps instead of spinning
+static void testWaitSleeps()
+{
+    cppgfx::JobSystem jobs(1);
+    std::atomic<bool> started { false };
+    auto task = jobs.submit([&started] {
+        started = true;
+        std::this_thread::sleep_for(300ms);
+    });
+    while (!started) {
+        std::this_thread::yield();
+    }
+    std::clock_t cpuBefore = std::clock();
+    task.wait();
+    double cpuSeconds = static_cast<double>(std::clock() - cpuBefore) / CLOCKS_PER_SEC;
+    CHECK(cpuSeconds < 0.1);
+}
+
+int main()
+{
+    testSubmissionOrder();
+    testGroups();
+    testTaskWithoutJob();
+    testParallelFor();
+    testWaitSleeps();
+
+    // The shared pool is the same while it is referenced
+    auto shared = cppgfx::JobSystem::shared();
+    CHECK(shared == cppgfx::JobSystem::shared());
+    return checkResult();
+}
@@ -0,0 +1,45 @@
+#include "check.hpp"
+#include "cppgfx/softwareblend.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace cppgfx::software;
+
+// The vector path of blendSpan() must produce exactly the same pixels as blendPixel()
+int main()
+{
+    std::mt19937 random(1);
+    auto byte = [&random]() { return static_cast<uint8_t>(random() & 0xFF); };
+
+    for (int round = 0; round < 2000; round++) {
+        sf::Color color(byte(), byte(), byte(), byte());
+        uint32_t alpha = (round % 4 == 0) ? 255 : byte();
+
+        // Lengths around the vector width, so that both the vector loop and the scalar tail are covered
+        size_t count = static_cast<size_t>(round % 19);
+        std::vector<uint32_t> span(count);
+        for (auto& pixel : span) {
+            pixel = static_cast<uint32_t>(random());
+        }
+        std::vector<uint32_t> expected = span;
+        for (auto& pixel : expected) {
+            if (alpha == 255) {
+                pixel = pack(color);
+            }
+            else {
+                blendPixel(pixel, color, alpha);
+            }
+        }
+
+        blendSpan(span.data(), span.size(), color, alpha);
+        CHECK(span == expected);
+    }
+
+    // div255() must be the exactly rounded division for every value it is used with
+    for (uint32_t x = 0; x <= 255 * 255; x++) {
+        CHECK(div255(x) == (x + 127) / 255);
+    }
+
+    return checkResult();
+}
@@ -0,0 +1,172 @@
+#include "check.hpp"
+#include "cppgfx/softwarerenderer.hpp"
+#include "cppgfx/robotofont.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+using cppgfx::SoftwareRenderer;
+
+static sf::Color pixel(const SoftwareRenderer& renderer, uint32_t x, uint32_t y)
+{
+    const uint8_t* p = renderer.getPixels() + (static_cast<size_t>(y) * renderer.getWidth() + x) * 4;
+    return sf::Color(p[0], p[1], p[2], p[3]);
+}
+
+// The sum of the red channel over the whole image, in fully red pixels
+static double redArea(const SoftwareRenderer& renderer)
+{
+    double sum = 0;
+    for (uint32_t y = 0; y < renderer.getHeight(); y++) {
+        for (uint32_t x = 0; x < renderer.getWidth(); x++) {
+            sum += pixel(renderer, x, y).r / 255.0;
+        }
+    }
+    return sum;
+}
+
+static bool samePixels(const SoftwareRenderer& a, const SoftwareRenderer& b)
+{
+    size_t size = static_cast<size_t>(a.getWidth()) * a.getHeight() * 4;
+    return a.getWidth() == b.getWidth() && a.getHeight() == b.getHeight()
+        && std::equal(a.getPixels(), a.getPixels() + size, b.getPixels());
+}
+
+static void testFill()
+{
+    SoftwareRenderer renderer(16, 8);
+    renderer.clear(sf::Color::Black);
+
+    // Pixel aligned, so every pixel is either fully covered or not at all
+    sf::Vector2f square[] = { { 2, 2 }, { 6, 2 }, { 6, 6 }, { 2, 6 } };
+    renderer.convex(square, 4, sf::Color::Red);
+    CHECK(pixel(renderer, 2, 2) == sf::Color::Red);
+    CHECK(pixel(renderer, 5, 5) == sf::Color::Red);
+    CHECK(pixel(renderer, 6, 5) == sf::Color::Black);
+    CHECK(pixel(renderer, 1, 3) == sf::Color::Black);
+    CHECK(pixel(renderer, 3, 6) == sf::Color::Black);
+
+    // The left column is covered by half
+    sf::Vector2f half[] = { { 8.5f, 0 }, { 10, 0 }, { 10, 4 }, { 8.5f, 4 } };
+    renderer.convex(half, 4, sf::Color::Red);
+    CHECK(pixel(renderer, 8, 1) == sf::Color(128, 0, 0));
+    CHECK(pixel(renderer, 9, 1) == sf::Color::Red);
+
+    // Half transparent, blended like sf::BlendAlpha
+    sf::Vector2f translucent[] = { { 12, 0 }, { 16, 0 }, { 16, 4 }, { 12, 4 } };
+    renderer.convex(translucent, 4, sf::Color(255, 0, 0, 128));
+    CHECK(pixel(renderer, 13, 1) == sf::Color(128, 0, 0));
+
+    // Shapes outside of the image are clipped
+    sf::Vector2f outside[] = { { -10, -10 }, { 30, -10 }, { 30, -2 } };
+    renderer.convex(outside, 3, sf::Color::Green);
+    CHECK(pixel(renderer, 15, 0) != sf::Color::Green);
+}
+
+static void testStroke()
+{
+    SoftwareRenderer renderer(16, 16);
+    renderer.clear(sf::Color::Black);
+
+    // A one pixel wide outline between two squares
+    sf::Vector2f outer[] = { { 2, 2 }, { 12, 2 }, { 12, 12 }, { 2, 12 } };
+    sf::Vector2f inner[] = { { 3, 3 }, { 11, 3 }, { 11, 11 }, { 3, 11 } };
+    renderer.ring(outer, inner, 4, sf::Color::Red);
+    CHECK(pixel(renderer, 2, 5) == sf::Color::Red);
+    CHECK(pixel(renderer, 11, 5) == sf::Color::Red);
+    CHECK(pixel(renderer, 5, 2) == sf::Color::Red);
+    CHECK(pixel(renderer, 5, 11) == sf::Color::Red);
+    CHECK(pixel(renderer, 3, 5) == sf::Color::Black);
+    CHECK(pixel(renderer, 7, 7) == sf::Color::Black);
+    CHECK(pixel(renderer, 1, 5) == sf::Color::Black);
+    CHECK(std::abs(redArea(renderer) - (100.0 - 64.0)) < 1e-6);
+}
+
+static void testCircle()
+{
+    SoftwareRenderer renderer(32, 32);
+    renderer.clear(sf::Color::Black);
+
+    constexpr size_t SEGMENTS = 64;
+    constexpr float RADIUS = 10;
+    constexpr double PI = 3.14159265358979323846;
+    sf::Vector2f points[SEGMENTS];
+    for (size_t i = 0; i < SEGMENTS; i++) {
+        float angle = static_cast<float>(2 * PI * static_cast<double>(i) / SEGMENTS);
+        points[i] = { 16 + RADIUS * std::cos(angle), 16 + RADIUS * std::sin(angle) };
+    }
+    renderer.convex(points, SEGMENTS, sf::Color::Red);
+
+    CHECK(pixel(renderer, 16, 16) == sf::Color::Red);
+    CHECK(pixel(renderer, 0, 0) == sf::Color::Black);
+    CHECK(pixel(renderer, 16, 4) == sf::Color::Black);
+
+    // The coverage adds up to the area of the polygon, up to the rounding of every pixel to 8 bits
+    double area = 0.5 * SEGMENTS * RADIUS * RADIUS * std::sin(2 * PI / SEGMENTS);
+    CHECK(std::abs(redArea(renderer) - area) < 1.0);
+}
+
+static void testText()
+{
+    cppgfx::TextStyle style;
+    style.characterSize = 24;
+    style.fillColor = sf::Color::Red;
+    style.outlineColor = sf::Color::Blue;
+
+    SoftwareRenderer renderer(128, 48);
+    renderer.clear(sf::Color::Black);
+    std::string text = "Hello";
+    float width = 0;
+    renderer.textWidths(&text, 1, style, &width);
+    CHECK(width > 0);
+    renderer.text(text, { 10, 10 }, 0, style);
+    renderer.flush();
+
+    // Ink is drawn, and only within the measured width plus the bearing of the first glyph
+    size_t inked = 0;
+    bool outside = false;
+    for (uint32_t y = 0; y < renderer.getHeight(); y++) {
+        for (uint32_t x = 0; x < renderer.getWidth(); x++) {
+            if (pixel(renderer, x, y).r > 0) {
+                inked++;
+                outside = outside || static_cast<float>(x) < 9 || static_cast<float>(x) > 14 + width || y < 9;
+            }
+        }
+    }
+    CHECK(inked > 50);
+    CHECK(!outside);
+
+    // The same drawing gives the same pixels, and the embedded font is the default
+    SoftwareRenderer again(128, 48);
+    again.clear(sf::Color::Black);
+    cppgfx::TextStyle explicitFont = style;
+    explicitFont.fontData = cppgfx::ROBOTO_MEDIUM_DATA;
+    explicitFont.fontDataSize = cppgfx::ROBOTO_MEDIUM_SIZE;
+    again.text(text, { 10, 10 }, 0, explicitFont);
+    CHECK(samePixels(renderer, again));
+
+    // An outline grows the text
+    SoftwareRenderer outlined(128, 48);
+    outlined.clear(sf::Color::Black);
+    style.outlineThickness = 2;
+    outlined.text(text, { 10, 10 }, 0, style);
+    size_t outlinePixels = 0;
+    for (uint32_t y = 0; y < outlined.getHeight(); y++) {
+        for (uint32_t x = 0; x < outlined.getWidth(); x++) {
+            sf::Color color = pixel(outlined, x, y);
+            outlinePixels += (color.r > 0 || color.b > 0) ? 1 : 0;
+        }
+    }
+    CHECK(outlinePixels > inked);
+}
+
+// Everything is drawn on the CPU, so this runs without a display or GPU
+int main()
+{
+    testFill();
+    testStroke();
+    testCircle();
+    testText();
+    return checkResult();
+}
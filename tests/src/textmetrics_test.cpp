@@ -0,0 +1,49 @@
+#include "check.hpp"
+#include "cppgfx/robotofont.hpp"
+#include "cppgfx/textmetrics.hpp"
+
+#include <string>
+#include <vector>
+
+// TextMetrics must measure exactly the width of the local bounds of an sf::Text
+int main()
+{
+    if (!hasDisplay()) {
+        fmt::print("Skipped, fonts need a display for their glyph textures\n");
+        return SKIP_TEST;
+    }
+
+    sf::Font font;
+    CHECK(font.loadFromMemory(cppgfx::ROBOTO_MEDIUM_DATA, cppgfx::ROBOTO_MEDIUM_SIZE));
+
+    // Pairs like AV, To, Wa and LT have kerning in Roboto
+    const std::vector<std::string> texts = {
+        "", "A", "AV", "AVA", "To", "Wa", "LT", "Type", "WAVE", "Yo, Tony! AWAY", " leading", "trailing ",
+        "tab\tstop", "two\nlines", "carriage\r\nreturn", "The quick brown fox jumps over the lazy dog",
+    };
+
+    cppgfx::TextMetrics metrics;
+    for (uint32_t characterSize : { 8u, 12u, 18u, 31u, 64u }) {
+        std::vector<float> widths(texts.size());
+        metrics.widths(texts.data(), texts.size(), font, 0, characterSize, widths.data());
+
+        for (size_t i = 0; i < texts.size(); i++) {
+            sf::Text text(texts[i], font, characterSize);
+            float expected = text.getLocalBounds().width;
+            CHECK(widths[i] == expected);
+            CHECK(metrics.width(texts[i], font, 0, characterSize) == expected);
+            if (widths[i] != expected) {
+                fmt::print(stderr, "  '{}' at {}px: {} instead of {}\n", texts[i], characterSize, widths[i], expected);
+            }
+        }
+    }
+
+    // The tables of an id are kept until the id is forgotten, then the font behind the id is measured again
+    sf::Font empty;
+    CHECK(metrics.width("WAVE", empty, 0, 18) > 0);
+    metrics.forget(0);
+    CHECK(metrics.width("WAVE", empty, 0, 18) == 0);
+    CHECK(metrics.width("WAVE", font, 1, 18) == sf::Text("WAVE", font, 18).getLocalBounds().width);
+
+    return checkResult();
+}